@@ -0,0 +1,479 @@
+/*
+ * bench_sanitize.c - Throughput and correctness harness for the headline sanitizer.
+ *
+ * Build with `make bench_sanitize`. Runs synthetic multilingual corpora plus any title dumps given on
+ * the command line (one title per line) through sanitize_headline(), sanitize_headline_to(),
+ * normalize_ascii_char() and utf8_sequence_length(), reporting input bytes per second for each.
+ * Every title is also checked against reference_sanitize(), a deliberately naive restatement of the
+ * sanitizer's rules, so the vectorized and table-driven paths are verified byte for byte.
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L // clock_gettime
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include "sanitize.h"
+
+// --- Structs ---
+
+// Titles stored back to back, each NUL-terminated, as the sanitizer sees them
+struct Corpus {
+    char name[64];
+    char *data;
+    size_t data_len;
+    size_t data_cap;
+    size_t bytes; // Title bytes, excluding terminators
+    char **titles;
+    size_t count;
+    size_t longest;
+};
+
+// Raw fragments a synthetic title is assembled from; weights are out of 100
+struct FragmentMix {
+    const char *name;
+    int ascii;
+    int latin;
+    int cyrillic;
+    int cjk;
+    int symbols; // Emoji, dropped punctuation, control characters, malformed UTF-8
+};
+
+// --- Constants ---
+#define DEFAULT_CORPUS_MB 16
+#define DEFAULT_ITERATIONS 5
+#define MIN_TITLE_BYTES 30
+#define MAX_TITLE_BYTES 200
+
+// --- Globals ---
+static const char *const ascii_fragments[] = {
+    "Markets", "rally", "as", "central", "bank", "holds", "rates", "steady", "City", "council", "approves",
+    "new", "transit", "plan", "Storm", "brings", "coastal", "flooding", "2024", "Q3", "$40m", "deal",
+    "report:", "update,", "(live)", "[video]", "#breaking", "it's", "\"exclusive\"", "-", "&", "/", "+", "!", "?"
+};
+static const char *const latin_fragments[] = {
+    "café", "résumé", "Zürich", "São Paulo", "España", "naïve", "Ångström", "Kraków", "façade", "Øresund", "Málaga"
+};
+static const char *const cyrillic_fragments[] = {
+    "Москва", "новости", "правительство", "экономика", "Київ", "выборы"
+};
+static const char *const cjk_fragments[] = {
+    "東京", "経済", "新闻", "北京", "서울", "뉴스", "台風", "株価", "選挙"
+};
+static const char *const symbol_fragments[] = {
+    "\xF0\x9F\x9A\x80", "\xF0\x9F\x93\x88", "\xE2\x9A\xA0\xEF\xB8\x8F", "\xE2\x80\x94", "\xE2\x80\x9C", "\xE2\x80\x99",
+    "%", "@", "*", "<b>", "|", "~", "\t", "\r\n", "\xFF", "\xC3", "\x80\x80", "  ",
+    "\xC2\xA0", "\xC2\xAD", "\xC2\x85", "\xE2\x80\x8B", "\xEF\xBB\xBF", // NBSP, soft hyphen, NEL, ZWSP, BOM
+    "\xC0\xAF", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\xE6\x97", "\xC3" "A" // Overlong, surrogate, too large, truncated
+};
+
+static const struct FragmentMix mixes[] = {
+    { "ascii",    100,  0,  0,  0,  0 },
+    { "latin",     70, 30,  0,  0,  0 },
+    { "cyrillic",  30,  0, 70,  0,  0 },
+    { "cjk",       20,  0,  0, 80,  0 },
+    { "mixed",     40, 15, 15, 15, 15 },
+};
+
+static volatile size_t benchmark_sink; // Keeps results observable so the timed loops can't be elided
+
+// --- Function Prototypes ---
+static double now_seconds(void);
+static uint32_t next_random(uint32_t *state);
+static bool corpus_reserve(struct Corpus *corpus, size_t extra);
+static bool corpus_add_title(struct Corpus *corpus, const char *title, size_t len);
+static bool corpus_index(struct Corpus *corpus);
+static const char *pick_fragment(const struct FragmentMix *mix, uint32_t *state);
+static bool build_synthetic_corpus(struct Corpus *corpus, const struct FragmentMix *mix, size_t target_bytes);
+static bool load_corpus_file(struct Corpus *corpus, const char *path);
+static void free_corpus(struct Corpus *corpus);
+static bool reference_allowed(unsigned char c);
+static size_t reference_decode(const unsigned char *s, uint32_t *codepoint);
+static bool reference_space(uint32_t cp);
+static bool reference_invisible(uint32_t cp);
+static size_t reference_sanitize(const char *title, char *out);
+static bool check_corpus(const struct Corpus *corpus, char *buffer, char *expected);
+static double time_sanitize_to(const struct Corpus *corpus, char *buffer);
+static double time_sanitize_alloc(const struct Corpus *corpus);
+static double time_normalize(const struct Corpus *corpus);
+static double time_sequence_length(const struct Corpus *corpus);
+static double megabytes_per_second(size_t bytes, double seconds);
+static bool run_corpus(const struct Corpus *corpus, int iterations);
+
+// --- Main Function ---
+int main(int argc, char *argv[]) {
+    int corpus_mb = DEFAULT_CORPUS_MB;
+    int iterations = DEFAULT_ITERATIONS;
+    int first_file = argc;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--mb") == 0 && i + 1 < argc) {
+            corpus_mb = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "Usage: %s [--mb N] [--iterations N] [titles.txt ...]\n", argv[0]);
+            return 2;
+        } else {
+            first_file = i;
+            break;
+        }
+    }
+    if (corpus_mb <= 0 || iterations <= 0) {
+        fprintf(stderr, "--mb and --iterations must be positive.\n");
+        return 2;
+    }
+
+    fprintf(stdout, "%-10s %9s %8s %14s %14s %14s %14s  %s\n", "corpus", "titles", "MB",
+            "sanitize_to", "sanitize", "normalize", "utf8_length", "oracle");
+
+    bool all_ok = true;
+    for (size_t m = 0; m < sizeof(mixes) / sizeof(mixes[0]); ++m) {
+        struct Corpus corpus = {0};
+        if (!build_synthetic_corpus(&corpus, &mixes[m], (size_t)corpus_mb * 1024 * 1024)) {
+            fprintf(stderr, "Out of memory building the %s corpus.\n", mixes[m].name);
+            free_corpus(&corpus);
+            return 1;
+        }
+        all_ok = run_corpus(&corpus, iterations) && all_ok;
+        free_corpus(&corpus);
+    }
+
+    for (int i = first_file; i < argc; ++i) {
+        struct Corpus corpus = {0};
+        if (!load_corpus_file(&corpus, argv[i])) {
+            fprintf(stderr, "Unable to load title dump %s.\n", argv[i]);
+            free_corpus(&corpus);
+            all_ok = false;
+            continue;
+        }
+        all_ok = run_corpus(&corpus, iterations) && all_ok;
+        free_corpus(&corpus);
+    }
+
+    fprintf(stdout, "(checksum %zu)\n", (size_t)benchmark_sink);
+    return all_ok ? 0 : 1;
+}
+
+// --- Function Implementations ---
+
+static double now_seconds(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+// xorshift32; fixed seeds keep synthetic corpora identical between runs and builds
+static uint32_t next_random(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static bool corpus_reserve(struct Corpus *corpus, size_t extra) {
+    size_t needed = corpus->data_len + extra;
+    if (needed <= corpus->data_cap) return true;
+    size_t capacity = corpus->data_cap ? corpus->data_cap : 4096;
+    while (capacity < needed) capacity *= 2;
+    char *grown = realloc(corpus->data, capacity);
+    if (!grown) return false;
+    corpus->data = grown;
+    corpus->data_cap = capacity;
+    return true;
+}
+
+static bool corpus_add_title(struct Corpus *corpus, const char *title, size_t len) {
+    if (!corpus_reserve(corpus, len + 1)) return false;
+    memcpy(corpus->data + corpus->data_len, title, len);
+    corpus->data[corpus->data_len + len] = '\0';
+    corpus->data_len += len + 1;
+    corpus->bytes += len;
+    corpus->count++;
+    if (len > corpus->longest) corpus->longest = len;
+    return true;
+}
+
+// Titles are indexed only once the buffer stops moving
+static bool corpus_index(struct Corpus *corpus) {
+    corpus->titles = malloc(sizeof(char *) * (corpus->count > 0 ? corpus->count : 1));
+    if (!corpus->titles) return false;
+    size_t offset = 0;
+    for (size_t i = 0; i < corpus->count; ++i) {
+        corpus->titles[i] = corpus->data + offset;
+        offset += strlen(corpus->titles[i]) + 1;
+    }
+    return true;
+}
+
+static const char *pick_fragment(const struct FragmentMix *mix, uint32_t *state) {
+    int roll = (int)(next_random(state) % 100);
+    const char *const *pool = ascii_fragments;
+    size_t pool_len = sizeof(ascii_fragments) / sizeof(ascii_fragments[0]);
+    if ((roll -= mix->ascii) >= 0) {
+        if ((roll -= mix->latin) < 0) {
+            pool = latin_fragments;
+            pool_len = sizeof(latin_fragments) / sizeof(latin_fragments[0]);
+        } else if ((roll -= mix->cyrillic) < 0) {
+            pool = cyrillic_fragments;
+            pool_len = sizeof(cyrillic_fragments) / sizeof(cyrillic_fragments[0]);
+        } else if ((roll -= mix->cjk) < 0) {
+            pool = cjk_fragments;
+            pool_len = sizeof(cjk_fragments) / sizeof(cjk_fragments[0]);
+        } else {
+            pool = symbol_fragments;
+            pool_len = sizeof(symbol_fragments) / sizeof(symbol_fragments[0]);
+        }
+    }
+    return pool[next_random(state) % pool_len];
+}
+
+static bool build_synthetic_corpus(struct Corpus *corpus, const struct FragmentMix *mix, size_t target_bytes) {
+    snprintf(corpus->name, sizeof(corpus->name), "%s", mix->name);
+    uint32_t state = 0x9E3779B9u;
+    char title[MAX_TITLE_BYTES + 32];
+    while (corpus->bytes < target_bytes) {
+        size_t goal = MIN_TITLE_BYTES + next_random(&state) % (MAX_TITLE_BYTES - MIN_TITLE_BYTES);
+        size_t len = 0;
+        while (len < goal) {
+            const char *fragment = pick_fragment(mix, &state);
+            size_t fragment_len = strlen(fragment);
+            if (len + fragment_len + 1 >= sizeof(title)) break;
+            memcpy(title + len, fragment, fragment_len);
+            len += fragment_len;
+            title[len++] = ' ';
+        }
+        if (!corpus_add_title(corpus, title, len)) return false;
+    }
+    return corpus_index(corpus);
+}
+
+// A dump is plain text with one title per line, e.g. exported from saved feed responses
+static bool load_corpus_file(struct Corpus *corpus, const char *path) {
+    const char *base = strrchr(path, '/');
+    snprintf(corpus->name, sizeof(corpus->name), "%s", base ? base + 1 : path);
+    FILE *file = fopen(path, "rb");
+    if (!file) return false;
+
+    char line[8192];
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        size_t len = strcspn(line, "\r\n");
+        if (len > 0) ok = corpus_add_title(corpus, line, len);
+    }
+    fclose(file);
+    return ok && corpus->count > 0 && corpus_index(corpus);
+}
+
+static void free_corpus(struct Corpus *corpus) {
+    free(corpus->data);
+    free(corpus->titles);
+    memset(corpus, 0, sizeof(*corpus));
+}
+
+static bool reference_allowed(unsigned char c) {
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) return true;
+    return c != '\0' && strchr(" .,:;!?'\"-_/&()[]#$+", c) != NULL;
+}
+
+// Decodes by arithmetic and rejects by value, independently of the table-driven decoder under test
+static size_t reference_decode(const unsigned char *s, uint32_t *codepoint) {
+    size_t len;
+    uint32_t cp;
+    if (s[0] >= 0xC0 && s[0] < 0xE0) {
+        len = 2;
+        cp = s[0] & 0x1F;
+    } else if (s[0] >= 0xE0 && s[0] < 0xF0) {
+        len = 3;
+        cp = s[0] & 0x0F;
+    } else if (s[0] >= 0xF0 && s[0] < 0xF8) {
+        len = 4;
+        cp = s[0] & 0x07;
+    } else {
+        return 0;
+    }
+    for (size_t k = 1; k < len; ++k) {
+        if (s[k] < 0x80 || s[k] > 0xBF) return 0;
+        cp = (cp << 6) | (s[k] & 0x3F);
+    }
+    static const uint32_t shortest[5] = { 0, 0, 0x80, 0x800, 0x10000 };
+    if (cp < shortest[len] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return 0;
+    *codepoint = cp;
+    return len;
+}
+
+static bool reference_space(uint32_t cp) {
+    static const uint32_t spaces[] = { 0xA0, 0x1680, 0x2028, 0x2029, 0x202F, 0x205F, 0x3000, 0xFFFD };
+    if (cp < 0xA0 || (cp >= 0x2000 && cp <= 0x200A)) return true;
+    for (size_t i = 0; i < sizeof(spaces) / sizeof(spaces[0]); ++i) {
+        if (cp == spaces[i]) return true;
+    }
+    return false;
+}
+
+static bool reference_invisible(uint32_t cp) {
+    return cp == 0xAD || (cp >= 0x200B && cp <= 0x200F) || (cp >= 0x202A && cp <= 0x202E)
+        || (cp >= 0x2060 && cp <= 0x206F) || cp == 0xFEFF || (cp >= 0xFFF9 && cp <= 0xFFFC) || cp == 0xFFFE || cp == 0xFFFF;
+}
+
+// The contract, written for clarity rather than speed: whitespace controls, Unicode spaces and malformed
+// bytes become one space each, spaces never lead, repeat or trail, ASCII outside the allowed set and
+// invisible format characters vanish, and every other well-formed UTF-8 character is copied as is
+static size_t reference_sanitize(const char *title, char *out) {
+    const unsigned char *p = (const unsigned char *)title;
+    size_t n = 0;
+    while (*p) {
+        unsigned char c = *p;
+        size_t len = 1;
+        bool space = false;
+        bool keep = false;
+        if (c < 0x80) {
+            space = c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+            keep = !space && reference_allowed(c);
+        } else {
+            uint32_t cp = 0;
+            len = reference_decode(p, &cp);
+            if (len == 0) {
+                len = 1;
+                space = true;
+            } else {
+                space = reference_space(cp);
+                keep = !space && !reference_invisible(cp);
+            }
+        }
+
+        if (space) {
+            if (n > 0 && out[n - 1] != ' ') out[n++] = ' ';
+        } else if (keep) {
+            memcpy(out + n, p, len);
+            n += len;
+        }
+        p += len;
+    }
+    while (n > 0 && out[n - 1] == ' ') n--;
+    out[n] = '\0';
+    return n;
+}
+
+static bool check_corpus(const struct Corpus *corpus, char *buffer, char *expected) {
+    for (size_t i = 0; i < corpus->count; ++i) {
+        const char *title = corpus->titles[i];
+        size_t expected_len = reference_sanitize(title, expected);
+        size_t actual_len = sanitize_headline_to(title, buffer);
+        if (actual_len != expected_len || memcmp(buffer, expected, expected_len + 1) != 0) {
+            fprintf(stderr, "%s: title %zu differs from the reference\n  input:    ", corpus->name, i);
+            for (const unsigned char *p = (const unsigned char *)title; *p; ++p) {
+                if (*p >= 0x20 && *p < 0x7F) fputc(*p, stderr);
+                else fprintf(stderr, "\\x%02X", *p);
+            }
+            fprintf(stderr, "\n  expected: \"%s\"\n  actual:   \"%s\"\n", expected, buffer);
+            return false;
+        }
+    }
+    return true;
+}
+
+static double time_sanitize_to(const struct Corpus *corpus, char *buffer) {
+    double start = now_seconds();
+    size_t total = 0;
+    for (size_t i = 0; i < corpus->count; ++i) {
+        total += sanitize_headline_to(corpus->titles[i], buffer);
+    }
+    double elapsed = now_seconds() - start;
+    benchmark_sink += total;
+    return elapsed;
+}
+
+static double time_sanitize_alloc(const struct Corpus *corpus) {
+    double start = now_seconds();
+    size_t total = 0;
+    for (size_t i = 0; i < corpus->count; ++i) {
+        char *clean = sanitize_headline(corpus->titles[i]);
+        if (clean) {
+            total += (unsigned char)clean[0];
+            free(clean);
+        }
+    }
+    double elapsed = now_seconds() - start;
+    benchmark_sink += total;
+    return elapsed;
+}
+
+static double time_normalize(const struct Corpus *corpus) {
+    const unsigned char *data = (const unsigned char *)corpus->data;
+    double start = now_seconds();
+    size_t total = 0;
+    for (size_t i = 0; i < corpus->data_len; ++i) {
+        total += (unsigned char)normalize_ascii_char(data[i]);
+    }
+    double elapsed = now_seconds() - start;
+    benchmark_sink += total;
+    return elapsed;
+}
+
+// Walks lead bytes the way the sanitizer does, so the cost per input byte is comparable
+static double time_sequence_length(const struct Corpus *corpus) {
+    const unsigned char *data = (const unsigned char *)corpus->data;
+    double start = now_seconds();
+    size_t steps = 0;
+    for (size_t i = 0; i < corpus->data_len; ++steps) {
+        size_t advance = utf8_sequence_length(data[i]);
+        i += advance ? advance : 1;
+    }
+    double elapsed = now_seconds() - start;
+    benchmark_sink += steps;
+    return elapsed;
+}
+
+static double megabytes_per_second(size_t bytes, double seconds) {
+    return seconds > 0.0 ? (double)bytes / (1024.0 * 1024.0) / seconds : 0.0;
+}
+
+// Best of N runs per function; the minimum is the least noisy estimate on a shared machine
+static bool run_corpus(const struct Corpus *corpus, int iterations) {
+    char *buffer = malloc(corpus->longest + 1);
+    char *expected = malloc(corpus->longest + 1);
+    if (!buffer || !expected) {
+        free(buffer);
+        free(expected);
+        return false;
+    }
+
+    bool ok = check_corpus(corpus, buffer, expected);
+    double best_to = 0.0, best_alloc = 0.0, best_normalize = 0.0, best_length = 0.0;
+    for (int i = 0; i < iterations; ++i) {
+        double t = time_sanitize_to(corpus, buffer);
+        if (i == 0 || t < best_to) best_to = t;
+        t = time_sanitize_alloc(corpus);
+        if (i == 0 || t < best_alloc) best_alloc = t;
+        t = time_normalize(corpus);
+        if (i == 0 || t < best_normalize) best_normalize = t;
+        t = time_sequence_length(corpus);
+        if (i == 0 || t < best_length) best_length = t;
+    }
+
+    fprintf(stdout, "%-10s %9zu %8.1f %9.1f MB/s %9.1f MB/s %9.1f MB/s %9.1f MB/s  %s\n",
+            corpus->name, corpus->count, corpus->bytes / (1024.0 * 1024.0),
+            megabytes_per_second(corpus->bytes, best_to), megabytes_per_second(corpus->bytes, best_alloc),
+            megabytes_per_second(corpus->data_len, best_normalize), megabytes_per_second(corpus->data_len, best_length),
+            ok ? "ok" : "MISMATCH");
+    free(buffer);
+    free(expected);
+    return ok;
+}
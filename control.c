@@ -0,0 +1,204 @@
+/*
+ * control.c - Loopback HTTP listener behind the control and metrics endpoint.
+ *
+ * Each request is read whole against one deadline, so a client that stalls or trickles bytes
+ * costs the serving thread at most a second and never anything else.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "control.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET socket_t;
+typedef int socklen_t;
+#define close_socket closesocket
+#define BAD_SOCKET INVALID_SOCKET
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+typedef int socket_t;
+#define close_socket close
+#define BAD_SOCKET (-1)
+#endif
+
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL // A client hanging up early must not raise SIGPIPE
+#else
+#define SEND_FLAGS 0
+#endif
+
+#define CONTROL_HEADER_MAX 2048
+#define CONTROL_REQUEST_TIMEOUT_MS 1000 // For the whole request, not each read
+
+static const char *status_text(int status) {
+    switch (status) {
+    case 200: return "OK";
+    case 202: return "Accepted";
+    case 400: return "Bad Request";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 503: return "Service Unavailable";
+    default: return "Error";
+    }
+}
+
+static uint64_t now_ms(void) {
+#ifdef _WIN32
+    return (uint64_t)GetTickCount64();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+#endif
+}
+
+static void set_recv_timeout(socket_t socket, int timeout_ms) {
+#ifdef _WIN32
+    DWORD timeout = (DWORD)timeout_ms;
+#else
+    struct timeval timeout = {timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+#endif
+    setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout));
+}
+
+// The value after a header name given in lower case with its colon, or NULL; header names are case-insensitive
+static const char *header_value(const char *headers, const char *name) {
+    for (const char *line = strchr(headers, '\n'); line && *line; line = strchr(line, '\n')) {
+        ++line;
+        size_t i = 0;
+        while (name[i] && line[i] && (line[i] | 0x20) == name[i]) ++i;
+        if (!name[i]) return line + i;
+    }
+    return NULL;
+}
+
+// recv bounded by what is left of the request's deadline; 0 once it has passed
+static int recv_until(socket_t client, char *buffer, size_t len, uint64_t deadline) {
+    uint64_t now = now_ms();
+    if (now >= deadline) return 0;
+    set_recv_timeout(client, (int)(deadline - now));
+    return recv(client, buffer, (int)len, 0);
+}
+
+static bool read_request(socket_t client, struct ControlRequest *request) {
+    const uint64_t deadline = now_ms() + CONTROL_REQUEST_TIMEOUT_MS;
+    char buffer[CONTROL_HEADER_MAX + CONTROL_BODY_MAX + 1];
+    size_t used = 0;
+    char *header_end = NULL;
+    while (!header_end && used < CONTROL_HEADER_MAX) {
+        int got = recv_until(client, buffer + used, CONTROL_HEADER_MAX - used, deadline);
+        if (got <= 0) return false;
+        used += (size_t)got;
+        buffer[used] = '\0';
+        header_end = strstr(buffer, "\r\n\r\n");
+    }
+    if (!header_end) return false;
+
+    char version[16];
+    if (sscanf(buffer, "%7s %63s %15s", request->method, request->path, version) != 3) return false;
+
+    *header_end = '\0';
+    // Browsers send Origin with every cross-site POST; curl and scrapers don't
+    request->from_browser = header_value(buffer, "origin:") != NULL;
+    const char *length = header_value(buffer, "content-length:");
+    size_t wanted = length ? (size_t)strtoul(length, NULL, 10) : 0;
+    if (wanted > CONTROL_BODY_MAX) wanted = CONTROL_BODY_MAX;
+    char *body = header_end + 4;
+    size_t have = used - (size_t)(body - buffer);
+    while (have < wanted) {
+        int got = recv_until(client, body + have, wanted - have, deadline);
+        if (got <= 0) break;
+        have += (size_t)got;
+    }
+    if (have > wanted) have = wanted;
+    memcpy(request->body, body, have);
+    request->body[have] = '\0';
+    request->body_len = have;
+    return true;
+}
+
+bool control_listen(struct ControlServer *server, int port) {
+    memset(server, 0, sizeof(*server));
+#ifdef _WIN32
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+#endif
+    socket_t listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener == BAD_SOCKET) return false;
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, (const char *)&reuse, sizeof(reuse));
+
+    // Loopback only: the endpoint can pause the ticker and put text on screen
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons((unsigned short)port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listener, 8) != 0) {
+        close_socket(listener);
+        return false;
+    }
+    server->socket = (uintptr_t)listener;
+    server->open = true;
+    return true;
+}
+
+int control_accept(struct ControlServer *server, int timeout_ms, struct ControlRequest *request) {
+    if (!server->open) return -1;
+    socket_t listener = (socket_t)server->socket;
+    fd_set ready;
+    FD_ZERO(&ready);
+    FD_SET(listener, &ready);
+    struct timeval timeout = {timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+    int status = select((int)listener + 1, &ready, NULL, NULL, &timeout);
+    if (status < 0) return -1;
+    if (status == 0) return 0;
+
+    socket_t client = accept(listener, NULL, NULL);
+    if (client == BAD_SOCKET) return 0;
+    memset(request, 0, sizeof(*request));
+    request->client = (uintptr_t)client;
+    if (!read_request(client, request)) {
+        control_respond(request, 400, "text/plain", "Bad request\n", 12);
+        return 0;
+    }
+    return 1;
+}
+
+void control_respond(struct ControlRequest *request, int status, const char *content_type, const char *body,
+                     size_t length) {
+    socket_t client = (socket_t)request->client;
+    char header[256];
+    int header_len = snprintf(header, sizeof(header),
+                              "HTTP/1.0 %d %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+                              status, status_text(status), content_type, length);
+    if (header_len > 0 && (size_t)header_len < sizeof(header)) {
+        send(client, header, header_len, SEND_FLAGS);
+        size_t sent = 0;
+        while (sent < length) {
+            int wrote = send(client, body + sent, (int)(length - sent), SEND_FLAGS);
+            if (wrote <= 0) break;
+            sent += (size_t)wrote;
+        }
+    }
+    close_socket(client);
+}
+
+void control_close(struct ControlServer *server) {
+    if (!server->open) return;
+    close_socket((socket_t)server->socket);
+    server->open = false;
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
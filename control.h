@@ -0,0 +1,42 @@
+/*
+ * control.h - Minimal HTTP/1.0 listener for the local control and metrics endpoint.
+ *
+ * Binds to the loopback address only and serves one short request per connection, which is all
+ * curl, a browser or a Prometheus scraper needs. Kept free of SDL so the socket code stays apart
+ * from the ticker; the caller decides what each path means.
+ */
+
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CONTROL_BODY_MAX 1024 // Longer request bodies are truncated
+
+struct ControlServer {
+    uintptr_t socket;
+    bool open;
+};
+
+// One parsed request; the connection stays open until control_respond answers it
+struct ControlRequest {
+    uintptr_t client;
+    char method[8];
+    char path[64];
+    char body[CONTROL_BODY_MAX + 1]; // NUL-terminated
+    size_t body_len;
+    bool from_browser; // Carried an Origin header, so a web page sent it
+};
+
+// Listens on 127.0.0.1:port; false if the port is taken or sockets are unavailable
+bool control_listen(struct ControlServer *server, int port);
+// Waits up to timeout_ms for a request: 1 when one was read, 0 on timeout, -1 if the listener failed
+int control_accept(struct ControlServer *server, int timeout_ms, struct ControlRequest *request);
+// Sends the response and closes the connection
+void control_respond(struct ControlRequest *request, int status, const char *content_type, const char *body,
+                     size_t length);
+void control_close(struct ControlServer *server);
+
+#endif
@@ -3,10 +3,12 @@
  *
  * Features:
  * - Renders smooth text using TrueType fonts (SDL_ttf).
- * - Parses news headlines safely using the cJSON library.
- * - Loads settings from an external 'config.ini' file.
- * - Each headline scrolls at an independent, random speed.
- * - Each headline is displayed in a random color from a predefined list.
+ * - Aggregates NewsAPI, Guardian and RSS feeds, downloaded in parallel with curl multi.
+ * - Extracts headlines with streaming JSON and RSS scanners as responses download.
+ * - Loads settings from an external 'config.ini' file and applies edits to it while running.
+ * - Each headline scrolls at an independent, random speed; any number of headlines rotate through the lanes that fit on screen.
+ * - Each headline is displayed in a color from a configurable palette, chosen by hashing its text.
+ * - Press H to toggle the frame-time HUD; timings can also be logged to CSV or JSON.
  * - Press SPACE to pause/resume scrolling.
  * - Press ESC to quit.
  */
@@ -15,20 +17,60 @@
 #include <SDL.h>
 #include <SDL_ttf.h>
 #include <stdio.h>
+#include <stdarg.h>
 #include <stdbool.h>
 #include <string.h>
 #include <ctype.h>
 #include <stdlib.h>
 #include <time.h>
+#include <float.h>
+#include <sys/stat.h>
 #include <curl/curl.h>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h> // Peak working set for --bench
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
 #include "cJSON.h" // For robust JSON parsing
+#include "sanitize.h"
+#include "snapshot.h"
+#include "control.h"
 
 // --- Structs ---
 
+// How headline text is turned into pixels
+enum TextRenderMode {
+    TEXT_RENDER_TEXTURE, // One full-width texture per headline
+    TEXT_RENDER_ATLAS,   // Shared glyph atlas, lines drawn as batched quads
+    TEXT_RENDER_TILED    // Coverage kept in memory, uploaded as fixed-width tiles while they are in view
+};
+
+#define MAX_RSS_FEEDS 4
+#define MAX_HEADLINE_COLORS 10
+#define MAX_DISPLAYS 8
+
+// Which displays the ticker covers
+enum DisplayLayout {
+    DISPLAY_PRIMARY, // One fullscreen window on the first display
+    DISPLAY_EACH,    // A fullscreen window per display
+    DISPLAY_SPAN     // One borderless window across every display
+};
+
+enum TelemetryFormat {
+    TELEMETRY_CSV,
+    TELEMETRY_JSON // One object per line
+};
+
 // Holds settings loaded from config.ini
 struct Config {
     char api_key[128];
     char font_path[256];
+    char fallback_fonts[256]; // Comma-separated, tried in order for characters font_path lacks
     char country_code[8]; // Added country code
     int font_size;
     int refresh_interval_seconds;
@@ -36,39 +78,714 @@ struct Config {
     float scroll_speed_min;
     float scroll_speed_max;
     SDL_Color background_color;
-    SDL_Color colors[10];
+    SDL_Color colors[MAX_HEADLINE_COLORS];
     int num_colors;
+    enum TextRenderMode text_render_mode;
+    enum DisplayLayout display_layout;
+    int texture_cache_mb;
+    int texture_budget_mb;
+    char response_cache_path[256];
+    char snapshot_path[256];
+    bool source_newsapi;
+    bool source_guardian;
+    bool source_rss;
+    char guardian_api_key[64];
+    char guardian_query[64];
+    char rss_urls[MAX_RSS_FEEDS][256];
+    int num_rss_urls;
+    int source_timeout_ms;
+    int max_headlines;
+    bool show_hud;
+    bool idle_when_static;
+    int frame_rate;       // Presents per second; 0 follows the display
+    bool adaptive_pacing; // Skip vblanks while motion stays smooth and frames keep up
+    char telemetry_path[256];
+    enum TelemetryFormat telemetry_format;
+    int telemetry_max_kb;
+    int control_port; // Loopback HTTP control and metrics endpoint; 0 disables it
+    char push_source[256]; // Server-Sent Events URL or named pipe of headlines; empty disables push ingest
+};
+
+// One glyph of an atlas-rendered line, positioned relative to the line origin
+struct GlyphQuad {
+    float x;
+    float y; // Baseline shift for glyphs from a fallback font
+    float w;
+    float h;
+    float u0, v0, u1, v1;
+};
+
+// A rasterized headline shared between line sets; lines hold references, the cache owns the texture
+struct TextureCacheEntry {
+    Uint64 key;
+    char *text; // Kept to rule out hash collisions
+    SDL_Color color;
+    int font_size;
+    SDL_Texture *texture;
+    int width;
+    int height;
+    size_t bytes;
+    int refs;
+    Uint64 last_used;
+};
+
+// Texture memory one renderer holds, counted as width * height * 4, against its share of texture_budget_mb
+struct TextureBudget {
+    size_t limit_bytes; // 0 leaves textures uncapped
+    size_t configured_bytes; // This renderer's share of texture_budget_mb; limit_bytes drops below it after a failure
+    Uint32 capped_at; // When a failed allocation last lowered limit_bytes
+    size_t line_bytes; // Textures lines own outright; cache and atlas bytes are counted where they live
+    size_t peak_bytes;
+    int evictions; // Off-screen lines and cached textures dropped to make room
+    int deferrals; // Times a lane was held at the edge until there was room
+    int failures; // Textures SDL could not allocate
+};
+
+// A line split into tiles of one width; only tiles near the viewport hold a texture
+struct LineTiles {
+    Uint8 *coverage; // texture_width * texture_height bytes, the line's alpha in system memory
+    int tile_width;
+    int count;
+    SDL_Texture **textures; // count entries, NULL while a tile is out of range
 };
 
 // Holds the data for a single scrolling line of text
 struct NewsLine {
     char* text;
     bool owns_text;
-    float scroll_x;
-    float scroll_speed;
-    int y_position;
+    int y_position; // Fixed per lane
+    int headline; // Store index being shown, or -1 when that headline is no longer in the store
     SDL_Color color;
     SDL_Texture* texture;
+    struct TextureCacheEntry *cached; // Set when texture is borrowed from the texture cache
+    struct TextureBudget *budget; // Set when the line owns its texture, so releasing it is accounted
+    struct GlyphQuad *quads; // Atlas mode only; texture stays NULL
+    struct LineTiles *tiles; // Tiled lines only; texture stays NULL
+    int quad_count;
     int texture_width;
     int texture_height;
+    int deferrals; // Refills spent waiting at the edge for texture room
 };
 
-// Used by libcurl to store fetched data in memory
+// Used by libcurl to store fetched data in memory; capacity grows geometrically and is kept between uses
 struct MemoryStruct {
     char *memory;
     size_t size;
+    size_t capacity;
 };
 
 // --- Constants ---
-#define MAX_LINES 20 // Maximum number of headlines to display
+#define DEFAULT_MAX_HEADLINES 100
+#define NEWSAPI_PAGE_MAX 100 // Largest pageSize NewsAPI accepts
+#define GUARDIAN_PAGE_MAX 200
 #define DEFAULT_LINE_PADDING 10
 #define DEFAULT_SCROLL_SPEED_MIN 90.0f
 #define DEFAULT_SCROLL_SPEED_MAX 220.0f
 #define DEFAULT_REFRESH_INTERVAL_SECONDS 0
 #define MAX_FETCH_ATTEMPTS 3
+#define MAX_FEED_SOURCES (2 + MAX_RSS_FEEDS) // NewsAPI, Guardian, then RSS feeds
+#define DEFAULT_SOURCE_TIMEOUT_MS 5000
+#define FRAME_HISTORY 256 // Frames kept for HUD percentiles; about four seconds at 60 Hz
+#define HUD_FONT_SIZE 14
+#define HUD_UPDATE_MS 500
+#define TELEMETRY_INTERVAL_MS 1000
+#define SCROLL_STEP_HZ 240 // Fixed simulation rate; a multiple of common refresh rates, interpolated for the rest
+#define MAX_SCROLL_STEPS 24 // Catch-up limit after a stall (100 ms); older backlog is dropped, not fast-forwarded
+#define CONFIG_FILE "config.ini"
+#define CONFIG_POLL_MS 1000 // Also bounded by IDLE_POLL_MS, so an idle ticker still notices edits
+#define IDLE_POLL_MS 250 // Longest idle wait, bounding how late a refreshed set appears while paused
+#define SOFTWARE_FRAME_RATE 30 // Default for the software renderer, which has no vsync and little time to spare
+#define PACING_MAX_INTERVAL 4 // Slowest adaptive pace, in refresh periods per present
+#define PACING_MAX_STEP_PX 2.0f // Adaptive pacing keeps the fastest lane's per-present step under this
+#define PACING_WINDOW_MS 1000
+#define PACING_LATE_PERCENT 10 // Late presents in a window that make adaptive pacing back off
+#define PACING_RECOVER_WINDOWS 5 // Clean windows before it tries a faster pace again
+#define DEFAULT_TELEMETRY_MAX_KB 1024
+#define BENCH_WIDTH 1920
+#define BENCH_HEIGHT 1080
+#define BENCH_DEFAULT_FRAMES 2000
+#define BENCH_DEFAULT_REFRESHES 20
+#define BENCH_DEFAULT_FIXTURE "bench/newsapi_fixture.json"
+#define BENCH_DEFAULT_SEED 1
+#define GLYPH_ATLAS_SIZE 1024
+#define GLYPH_ATLAS_PADDING 1
+#define GLYPH_BATCH_QUADS 1024
+#define LINE_TILE_WIDTH 512
+#define TEXTURE_DEFERRAL_LIMIT 120 // Refills a line waits at the edge for room before it is tiled instead
+#define TEXTURE_CAP_RECOVERY_MS 10000 // How long a cap set by a failed allocation holds before the budget is tried again
+#define MAX_FONT_CHAIN 6 // font_path plus up to five fallbacks
+#define FONT_RESOLVE_SLOTS 1024 // Direct-mapped codepoint-to-font memo; must be a power of two
+#define SHAPE_CACHE_MAX 512 // Shaped headlines kept across refreshes, dropped LRU-first
+#define HEADLINE_SOURCE_SUFFIX_MAX 40 // Longest trailing " - Publisher" ignored when comparing stories
+#define CONTROL_QUEUE_SLOTS 16 // Commands waiting for the render loop; more are refused until it catches up
+#define CONTROL_ACCEPT_TIMEOUT_MS 250 // Longest the control thread takes to notice shutdown
+#define CONTROL_METRICS_MAX 16384
+#define PUSH_RETRY_MIN_MS 1000 // Reconnect backoff for a dropped push stream, doubling up to the max
+#define PUSH_RETRY_MAX_MS 60000
+#define PUSH_POLL_MS 250 // How often a quiet pipe checks for shutdown
+#define PUSH_STALL_SECONDS 300 // A stream silent this long, keepalive comments included, is reconnected
+// SDL_ttf 2.0.18 added 32-bit glyph entry points; older releases only reach the BMP. Compared by hand because
+// SDL_TTF_VERSION_ATLEAST itself only arrived in 2.0.18.
+#if SDL_TTF_MAJOR_VERSION > 2 || (SDL_TTF_MAJOR_VERSION == 2 && (SDL_TTF_MINOR_VERSION > 0 || SDL_TTF_PATCHLEVEL >= 18))
+#define TTF_HAS_UCS4 1
+#endif
+#define DEFAULT_TEXTURE_CACHE_MB 32
+#define DEFAULT_RESPONSE_CACHE_PATH "news_cache.dat"
+#define DEFAULT_SNAPSHOT_PATH "news_snapshot.bin"
+#ifdef _WIN32
+#define DEFAULT_FALLBACK_FONTS "C:/Windows/Fonts/seguisym.ttf,C:/Windows/Fonts/msyh.ttc,C:/Windows/Fonts/malgun.ttf,C:/Windows/Fonts/arial.ttf"
+#else
+#define DEFAULT_FALLBACK_FONTS "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf,/usr/share/fonts/opentype/noto/NotoSansCJK-Regular.ttc,/usr/share/fonts/truetype/noto/NotoSansArabic-Regular.ttf"
+#endif
+#define RESPONSE_CACHE_MAGIC "news-ticker-cache"
+#define RESPONSE_CACHE_VERSION "1"
+#define RESPONSE_BUFFER_INITIAL (16 * 1024)
+#define RESPONSE_BUFFER_MAX_HINT (8 * 1024 * 1024) // Content-Length beyond this is not trusted for preallocation
+#define RESPONSE_BUFFER_KEEP (1024 * 1024) // Larger buffers are released after a fetch instead of kept
+#define FNV_OFFSET_BASIS 14695981039346656037ull
+#define FNV_PRIME 1099511628211ull
 
 #define STATUS_BUFFER 256
 
+#define ARENA_BLOCK_SIZE 4096
+
+// One chunk of a StringArena; data follows the header
+struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t used;
+    size_t capacity;
+    char data[];
+};
+
+// Bump allocator for strings that all die together, so a headline set costs a block, not a malloc per line
+struct StringArena {
+    struct ArenaBlock *head;
+};
+
+// A headline waiting for a lane: a compact text record, rasterized only while a lane shows it
+struct Headline {
+    char *text;
+    SDL_Color color;
+    bool shown; // Assigned to a lane right now
+    Uint64 identity; // headline_identity(text)
+    bool injected; // From the control endpoint or push_source; the store owns a malloc'd copy of its text
+    bool waiting; // Injected or repeated and not yet dealt to a lane; these go first, oldest first
+    Uint64 queued; // Order it was injected or repeated in
+};
+
+// How a rebuilt set compares with the one it replaces
+struct HeadlineDiff {
+    int added;
+    int kept;
+    int removed;
+    int duplicates; // Titles dropped because the set already had the story
+};
+
+// Every headline of one generation; lanes take from it in rotation, so its size is independent of the screen
+struct HeadlineStore {
+    struct Headline *items;
+    int count;
+    int capacity;
+    int *slots; // Open-addressed identity index: item index + 1, 0 when empty
+    int slot_capacity; // Power of two, kept at least twice count
+    int cursor; // Where the next lane that wraps starts looking
+    bool used_fallback;
+    struct HeadlineDiff diff; // Against the previous set, filled in by build_headline_store
+    struct StringArena arena; // Backs every polled headline's text; reset when the store is retired
+    int injected; // Injected stories in the set, held to max_headlines
+    Uint64 queue_clock;
+};
+
+// PCG32: small, fast and seedable; each consumer owns one, so no generator is shared between threads
+struct Rng {
+    Uint64 state;
+    Uint64 increment; // Odd; selects the stream
+};
+
+// Horizontal bands that fit one display; only lanes hold textures, however many headlines there are
+struct LanePool {
+    struct NewsLine *lines; // Cold per-lane state: text, textures, color
+    int count;
+    SDL_Rect area; // The display's part of its window; lanes scroll and clip within it
+    // Hot per-lane state, one float each, so the fixed step is a straight pass over contiguous arrays
+    float *motion; // Backs the four arrays below
+    float *x;
+    float *prev_x; // Position one simulation step earlier; frames interpolate between the two
+    float *speed; // Zero for an empty lane
+    float *wrap_x; // Lane has left the screen once x drops below this; -FLT_MAX until rasterized
+    unsigned char *wrapped; // Set by the step; refill_lanes hands the lane its next headline
+    struct Rng rng; // Respawn offsets and speeds; seeded per display so a seed replays every screen's layout
+};
+
+// Text-only result of one fetch pass; rasterization stays on the render thread
+struct HeadlineBatch {
+    struct StringArena arena; // Backs titles; handed to the HeadlineStore built from this batch
+    char **titles;
+    int count;
+    int capacity;
+    int limit; // Most titles collected; 0 for no limit
+    int sources; // Feeds that contributed at least one title
+    bool not_modified; // No feed changed; the headlines on screen are still current
+    char error[STATUS_BUFFER];
+};
+
+#define JSON_MAX_DEPTH 64
+#define JSON_KEY_DEPTH 8     // Keys are only remembered this deep; feed paths are much shallower
+#define JSON_KEY_MAX 32
+#define JSON_PATH_MAX 3
+#define JSON_CAPTURE_MAX 4096 // Longest string value kept; anything longer is truncated
+
+enum FeedFormat {
+    FEED_FORMAT_JSON,
+    FEED_FORMAT_RSS // RSS 2.0 <item> or Atom <entry> titles
+};
+
+// Which string fields a streaming scan pulls out of a JSON feed; paths are NULL-terminated key lists
+struct JsonFeedSchema {
+    const char *status_path[JSON_PATH_MAX + 1];
+    const char *status_ok;
+    const char *items_path[JSON_PATH_MAX + 1];
+    const char *title_key;
+};
+
+enum JsonLexState {
+    JSON_LEX_STRUCTURE,
+    JSON_LEX_STRING,
+    JSON_LEX_ESCAPE,
+    JSON_LEX_UNICODE,
+    JSON_LEX_LITERAL
+};
+
+enum JsonCapture {
+    JSON_CAPTURE_NONE,
+    JSON_CAPTURE_KEY,
+    JSON_CAPTURE_STATUS,
+    JSON_CAPTURE_TITLE
+};
+
+// Incremental scanner fed as bytes arrive; only keys and the schema's fields are ever copied
+struct JsonStreamScanner {
+    const struct JsonFeedSchema *schema;
+    enum JsonLexState lex;
+    enum JsonCapture capture;
+    char containers[JSON_MAX_DEPTH]; // '{' or '[' per open level
+    char keys[JSON_KEY_DEPTH][JSON_KEY_MAX]; // Last key seen at each object level
+    int depth;
+    bool expecting_key;
+    bool seen_value;
+    bool failed;
+    bool saw_status;
+    bool status_ok;
+    Uint32 unicode;
+    int unicode_digits;
+    Uint32 high_surrogate;
+    char *text; // Capture buffer, reused for every kept string
+    size_t text_len;
+    size_t text_cap;
+    void (*on_title)(void *ctx, const char *title);
+    void *ctx;
+};
+
+#define RSS_TAG_MAX 64 // Tag text kept for name matching; longer tags are truncated
+#define RSS_ENTITY_MAX 12
+
+enum RssLexState {
+    RSS_LEX_TEXT,
+    RSS_LEX_TAG,
+    RSS_LEX_ENTITY,
+    RSS_LEX_CDATA,
+    RSS_LEX_COMMENT
+};
+
+// Incremental RSS/Atom scanner; only <title> text directly inside an <item> or <entry> is kept
+struct RssStreamScanner {
+    enum RssLexState lex;
+    char tag[RSS_TAG_MAX];
+    size_t tag_len;
+    char quote; // Open attribute quote inside a tag, or 0
+    char entity[RSS_ENTITY_MAX];
+    size_t entity_len;
+    int terminator_match; // Characters of "]]>" or "-->" matched so far
+    int depth;
+    int item_depth; // Element depth of the open item or entry, 0 outside one
+    bool in_title;
+    bool seen_element;
+    bool failed;
+    char text[JSON_CAPTURE_MAX];
+    size_t text_len;
+    void (*on_title)(void *ctx, const char *title);
+    void *ctx;
+};
+
+// HTTP cache validators remembered from the last successful response
+struct ResponseValidators {
+    char etag[256];
+    char last_modified[128];
+};
+
+// curl write/header target: the reused body buffer for the disk cache plus the scanner consuming it
+struct FeedReceiver {
+    enum FeedFormat format;
+    struct MemoryStruct *body;
+    struct JsonStreamScanner scanner;
+    struct RssStreamScanner rss;
+    struct ResponseValidators received;
+    Uint64 parse_ticks; // Performance-counter time spent inside the scanner
+};
+
+// Network and parse cost of one source in a refresh pass, measured on the worker
+struct SourceTiming {
+    char name[24];
+    bool ok;
+    long http_code;
+    double dns_ms;
+    double connect_ms;
+    double tls_ms;
+    double wait_ms;     // Request sent to first byte
+    double transfer_ms; // First byte to last
+    double parse_ms;
+    size_t bytes;
+};
+
+// Handed from the worker to the render loop after every pass, including 304-only ones
+struct RefreshMetrics {
+    struct SourceTiming sources[MAX_FEED_SOURCES];
+    int source_count;
+    double total_ms;
+};
+
+// One feed polled every refresh; its easy handle and buffers persist so passes reuse connections
+struct FeedSource {
+    char name[24]; // Room for "RSS feed " and any int
+    char url[512];
+    char cache_path[272];
+    enum FeedFormat format;
+    const struct JsonFeedSchema *schema; // JSON feeds only
+    CURL *curl;
+    char curl_error[CURL_ERROR_SIZE];
+    struct curl_slist *request_headers;
+    struct ResponseValidators validators;
+    struct MemoryStruct response; // Receive buffer reused across attempts and refreshes
+    struct FeedReceiver receiver;
+    struct HeadlineBatch latest;   // Last good titles; stay in rotation while the feed is unchanged or down
+    struct HeadlineBatch incoming; // Filled while downloading, swapped into latest on success
+    bool active;  // Attached to the multi handle
+    bool settled; // Finished this pass with new titles or a 304
+    bool fresh;   // Delivered new titles this pass
+    struct SourceTiming timing; // Last attempt of the current pass
+};
+
+// A glyph rasterized once into the shared atlas texture
+struct AtlasGlyph {
+    Uint32 codepoint;
+    int font; // Index into the font chain; fallback glyphs share the one atlas texture
+    bool present;
+    bool resident; // False when the glyph has no pixels or the atlas was full
+    bool spilled;  // Has pixels the full atlas had no room for
+    SDL_Rect src;
+    int x_offset;
+    int y_offset;
+    int advance;
+};
+
+// Shelf-packed texture of white glyphs; lines tint them through vertex colors
+struct GlyphAtlas {
+    SDL_Texture *texture;
+    int width;
+    int height;
+    int pen_x;
+    int pen_y;
+    int row_height;
+    int line_height;
+    bool full; // Some glyph didn't fit; lines that need one are drawn from their own texture
+    struct AtlasGlyph *glyphs; // Open-addressed, sized from how many glyphs the texture can hold
+    Uint32 slot_mask;
+    SDL_Vertex *vertices; // Scratch batch reused every frame
+    int *indices;
+};
+
+// Headline textures keyed by text, color and font size, evicted LRU-first past a byte budget.
+// A linear scan is plenty at headline-set sizes and keeps entry pointers stable for lines.
+struct TextureCache {
+    struct TextureCacheEntry **entries;
+    int count;
+    int capacity;
+    size_t bytes;
+    size_t budget_bytes;
+    Uint64 clock;
+    int hits;
+    int misses;
+};
+
+// A line the next snapshot will hold; coverage stays NULL until the line has been rasterized
+struct SnapshotCapture {
+    Uint64 key;
+    char *text;
+    int width;
+    int height;
+    Uint8 *coverage;
+    bool skipped; // Failed to rasterize; left out rather than holding the snapshot back
+};
+
+// Rasterized lines from the last run, mapped at startup so a restart uploads them instead of calling FreeType.
+// Each headline set records its first screenful as it is drawn, and the file is rewritten once that is complete.
+struct LineSnapshot {
+    char path[256];
+    Uint64 font_id;
+    struct SnapshotFile file;
+    struct SnapshotCapture *captures;
+    int capture_count;
+    int captured;
+    int hits;
+};
+
+// One stretch of a headline drawn from a single font of the chain
+struct ShapedRun {
+    int font;
+    int start;  // Byte offset into the text
+    int length; // Bytes
+    int x;      // Pen position where the run starts
+};
+
+// A headline itemized into font runs and measured, done once per distinct text and font chain
+struct ShapedLine {
+    Uint64 key;
+    char *text; // Kept to rule out hash collisions
+    int width;
+    int height;
+    Uint64 last_used;
+    int run_count;
+    struct ShapedRun runs[];
+};
+
+struct FontChoice {
+    Uint32 codepoint;
+    int font; // -1 when no font in the chain has the glyph
+    bool known;
+};
+
+// Ordered fonts tried per character, shared by every window like the primary font always was.
+// fonts[0] is font_path (or its system fallback); the rest come from fallback_fonts at the same size.
+struct FontChain {
+    TTF_Font *fonts[MAX_FONT_CHAIN];
+    int ascent[MAX_FONT_CHAIN];
+    int count;
+    struct FontChoice resolved[FONT_RESOLVE_SLOTS];
+    struct ShapedLine **shaped;
+    int shaped_count;
+    Uint64 clock;
+    int shape_hits;
+    int shape_misses;
+};
+
+// Everything needed to rasterize a line: renderer, fonts, and the atlas or texture cache when enabled
+struct TextRenderer {
+    SDL_Renderer *renderer;
+    struct FontChain *fonts;
+    TTF_Font *font; // fonts->fonts[0]; sets line height and lane spacing
+    int font_size;
+    enum TextRenderMode mode;
+    struct GlyphAtlas atlas;
+    struct TextureCache cache;
+    struct LineSnapshot *snapshot; // Shared by every window; NULL when disabled
+    struct TextureBudget budget;
+    int max_texture_width; // Wider lines are tiled in texture mode too; 0 when the renderer sets no limit
+    int tile_width;
+};
+
+// One output window; SDL textures belong to a single renderer, so each window keeps its own text renderer
+struct TickerWindow {
+    SDL_Window *window;
+    SDL_Renderer *renderer;
+    struct TextRenderer text_renderer;
+    struct LanePool pools[MAX_DISPLAYS]; // One per display the window covers
+    int pool_count;
+    int width;
+    int height;
+};
+
+// Background fetch thread state shared with the render loop
+enum ControlCommandKind {
+    CONTROL_PAUSE,
+    CONTROL_RESUME,
+    CONTROL_INJECT
+};
+
+struct ControlCommand {
+    enum ControlCommandKind kind;
+    char text[CONTROL_BODY_MAX + 1]; // Headline for CONTROL_INJECT
+};
+
+// Ring with one producer thread and one consumer, the render loop; neither side ever blocks
+struct CommandQueue {
+    struct ControlCommand slots[CONTROL_QUEUE_SLOTS];
+    SDL_atomic_t head; // Next slot the producer fills
+    SDL_atomic_t tail; // Next slot the render loop takes
+};
+
+struct FetchWorker {
+    SDL_Thread *thread;
+    SDL_mutex *lock;
+    SDL_cond *wake;
+    SDL_atomic_t shutdown;
+    SDL_atomic_t refresh_requested; // Ends the wait between passes early; see request_refresh
+    void *ready; // Latest unconsumed struct HeadlineBatch*, swapped atomically
+    void *metrics; // Latest unconsumed struct RefreshMetrics*, swapped atomically
+    struct Config config; // Private copy so the worker never reads main-thread state
+    // Owned by the worker thread for the life of the process so refreshes reuse DNS, TLS and connections
+    CURLM *multi;
+    CURLSH *share;
+    struct FeedSource sources[MAX_FEED_SOURCES];
+    int source_count;
+    SDL_Thread *push_thread; // Reads config.push_source; started and joined by the fetch thread
+    struct CommandQueue pushed; // One CONTROL_INJECT per pushed story, drained by the render loop
+    Uint32 wake_event; // Pushed with each story so an idle render loop takes it at once
+};
+
+// Turns push_source bytes into headlines: SSE events from a stream, or one line each from a pipe
+struct PushReader {
+    struct FetchWorker *worker;
+    bool events; // Server-Sent Events framing
+    char line[CONTROL_BODY_MAX + 1];
+    size_t line_len;
+    bool after_cr; // A \n straight after \r ends the same line
+    char data[CONTROL_BODY_MAX + 1];
+    size_t data_len;
+    bool has_data;
+    bool other_event; // Named event that isn't a headline, like a server ping
+    char last_event_id[128]; // Sent back on reconnect so the server can replay what was missed
+    int received;
+};
+
+// CPU-side cost of one frame, split by phase
+struct FrameSample {
+    float update_ms;
+    float render_ms;  // RenderClear plus every copy and geometry call
+    float present_ms; // Mostly the vsync wait
+    float frame_ms;   // Present to present
+    float target_ms;  // Interval the pacer aimed for; 0 means one refresh period
+};
+
+// Ring of recent frames; summaries are computed on demand for the HUD and the telemetry log
+struct FrameStats {
+    struct FrameSample samples[FRAME_HISTORY];
+    int head;
+    int count;
+    int unlogged; // Frames recorded since the last telemetry record
+    double refresh_period_ms;
+};
+
+// Decides when the next present is due. With vsync, presents land on every interval-th vblank;
+// without it a timer stands in for the vblank at the same period.
+struct FramePacer {
+    double refresh_ms;
+    int interval;     // Refresh periods per present
+    int min_interval; // From frame_rate, or the software renderer default
+    int load_interval; // Backoff the adaptive pacer has taken for late frames
+    bool adaptive;
+    bool vsync;
+    bool software;
+    Uint64 last_present;
+    double window_ms;
+    int window_frames;
+    int window_late;
+    int clean_windows;
+    int missed_total; // Late presents since startup, reported at exit
+};
+
+struct FrameSummary {
+    int frames;
+    float fps;
+    float frame_avg_ms;
+    float frame_p99_ms;
+    float frame_max_ms;
+    float update_ms;
+    float render_ms;
+    float present_ms;
+    int late;    // Frames that missed their vsync
+    int dropped; // Refresh periods skipped by those frames
+};
+
+// Rolling telemetry log; rotated to <path>.1 once it passes max_bytes
+struct TelemetryLog {
+    FILE *file;
+    char path[256];
+    enum TelemetryFormat format;
+    long max_bytes;
+    long written;
+};
+
+// Toggleable metrics overlay, re-rendered a few times a second rather than every frame
+struct Hud {
+    TTF_Font *font;
+    SDL_Texture *texture;
+    int width;
+    int height;
+    bool visible;
+    Uint32 next_update;
+    struct RefreshMetrics refresh;
+    bool has_refresh;
+    int rebuild_lines;
+    struct HeadlineDiff rebuild_diff;
+    double rasterize_ms;
+    struct TextureBudget textures; // Totals across windows, refreshed with the HUD
+    size_t texture_bytes;
+    float paced_fps;
+};
+
+// Detects edits to config.ini by polling its size and modification time
+struct ConfigWatch {
+    time_t mtime;
+    long long size;
+    Uint32 next_check;
+};
+
+// What the control endpoint reports; the render loop publishes a fresh copy every telemetry interval
+struct ControlMetrics {
+    struct FrameSummary frames; // Over the recent frame history
+    int missed_presents; // Since launch
+    struct RefreshMetrics refresh; // Latest fetch pass
+    bool has_refresh;
+    int refreshes;
+    Uint64 cache_hits; // Texture cache, since launch
+    Uint64 cache_misses;
+    size_t texture_bytes;
+    struct TextureBudget textures;
+    int shape_hits;
+    int shape_misses;
+    int headlines;
+    bool paused;
+    double uptime_seconds;
+};
+
+// Seqlock around the published metrics: the render loop never waits, readers retry if it wrote meanwhile
+struct MetricsBoard {
+    SDL_atomic_t sequence; // Odd while a write is in progress
+    struct ControlMetrics metrics;
+};
+
+// Serves the control endpoint from its own thread so a slow client can't touch a frame
+struct ControlWorker {
+    SDL_Thread *thread;
+    SDL_atomic_t shutdown;
+    struct ControlServer server;
+    struct CommandQueue commands;
+    struct MetricsBoard board;
+    struct FetchWorker *fetch; // Refresh requests go straight to the fetch worker
+    Uint32 wake_event; // Pushed after queueing a command so an idle loop picks it up at once
+};
+
+// Command-line switches; everything else comes from config.ini
+struct LaunchOptions {
+    bool bench;
+    int bench_frames;
+    int bench_refreshes;
+    const char *bench_fixture;
+    bool has_seed;
+    Uint64 seed;
+    bool verbose; // Per-refresh cache report on stdout; telemetry carries the same numbers
+};
+
 // --- Globals ---
 const char* fallback_news[] = {
     "HELLO! THIS IS THE DEFAULT NEWS FEED.",
@@ -78,25 +795,229 @@ const char* fallback_news[] = {
     NULL
 };
 
+static const struct JsonFeedSchema newsapi_schema = {
+    .status_path = { "status", NULL },
+    .status_ok = "ok",
+    .items_path = { "articles", NULL },
+    .title_key = "title"
+};
+
+// The Guardian content API, as used by index.html
+static const struct JsonFeedSchema guardian_schema = {
+    .status_path = { "response", "status", NULL },
+    .status_ok = "ok",
+    .items_path = { "response", "results", NULL },
+    .title_key = "webTitle"
+};
+
 // --- Function Prototypes ---
 static size_t WriteMemoryCallback(void *contents, size_t size, size_t nmemb, void *userp);
+static bool reserve_memory(struct MemoryStruct *mem, size_t capacity);
+static void free_memory(struct MemoryStruct *mem);
 bool parse_config(struct Config* config, char *error_message, size_t message_len);
-void render_text(SDL_Renderer* renderer, TTF_Font* font, struct NewsLine* line);
+static bool parse_hex_color(const char *text, SDL_Color *color);
+static bool parse_color_list(char *value, struct Config *config);
+void watch_config_file(struct ConfigWatch *watch);
+bool poll_config_file(struct ConfigWatch *watch);
+void apply_config_reload(struct Config *config, const struct Config *next, struct TickerWindow *windows, int window_count, struct HeadlineStore *store, struct Hud *hud, struct LineSnapshot *snapshot, struct FontChain *fonts, const char **font_file);
+static bool reload_font(struct Config *config, const struct Config *previous, struct TickerWindow *windows, int window_count, struct Hud *hud, struct LineSnapshot *snapshot, struct FontChain *fonts, const char **font_file);
+void render_text(struct TextRenderer *text_renderer, struct NewsLine *line);
+static void render_line_texture(struct TextRenderer *text_renderer, struct NewsLine *line);
+void open_line_snapshot(struct LineSnapshot *snapshot, const char *font_file, TTF_Font *font, const struct Config *config);
+void close_line_snapshot(struct LineSnapshot *snapshot);
+void plan_line_snapshot(struct LineSnapshot *snapshot, const struct TickerWindow *windows, int window_count, int font_size);
+void settle_line_snapshot(struct LineSnapshot *snapshot, struct TickerWindow *windows, int window_count);
+void flush_line_snapshot(struct LineSnapshot *snapshot);
+static void clear_snapshot_captures(struct LineSnapshot *snapshot);
+static bool texture_from_snapshot(struct TextRenderer *text_renderer, Uint64 key, struct NewsLine *line);
+static void capture_line_snapshot(struct LineSnapshot *snapshot, Uint64 key, const struct NewsLine *line, SDL_Surface *surface);
+static struct SnapshotCapture *wanted_capture(struct LineSnapshot *snapshot, Uint64 key, const char *text);
+static Uint8 *surface_coverage(SDL_Surface *surface);
+static SDL_Texture *texture_from_coverage(SDL_Renderer *renderer, const Uint8 *coverage, int pitch, int width, int height, SDL_Color color);
+static bool line_exceeds_texture(struct TextRenderer *text_renderer, const struct NewsLine *line);
+static void build_line_tiles(struct TextRenderer *text_renderer, struct NewsLine *line);
+static void stream_line_tiles(struct TextRenderer *text_renderer, struct LanePool *pool, int lane, float raster_edge);
+static void release_line_tiles(struct NewsLine *line);
+static bool font_has_glyph(TTF_Font *font, uint32_t codepoint);
+static bool font_provides_glyph(uint32_t codepoint, void *ctx);
+static bool drop_missing_glyphs(struct FontChain *fonts, char *text);
+bool open_font_chain(struct FontChain *fonts, const struct Config *config, const char **opened_path);
+void close_font_chain(struct FontChain *fonts);
+static int font_for_codepoint(struct FontChain *fonts, uint32_t codepoint);
+static struct ShapedLine *itemize_line(struct FontChain *fonts, const char *text, Uint64 key);
+static const struct ShapedLine *shape_line(struct FontChain *fonts, const char *text);
+static SDL_Surface *render_shaped_text(struct FontChain *fonts, const char *text, SDL_Color color);
 void trim_whitespace(char *str);
-char* sanitize_headline(const char *title);
+char *arena_reserve(struct StringArena *arena, size_t len);
+void arena_commit(struct StringArena *arena, size_t len);
+char *arena_strdup(struct StringArena *arena, const char *text);
+void arena_reset(struct StringArena *arena);
+void arena_free(struct StringArena *arena);
 void release_news_line(struct NewsLine *line);
-bool init_news_line(struct NewsLine *line, SDL_Renderer *renderer, TTF_Font *font, char *text, bool owns_text, SDL_Color color, int screen_width, int screen_height, int *y_cursor, const struct Config *config);
+void release_line_pixels(struct NewsLine *line);
 void append_message(char *buffer, size_t len, const char *message);
-char normalize_ascii_char(unsigned char c);
-size_t utf8_sequence_length(unsigned char lead_byte);
-void clear_news_lines(struct NewsLine *lines, int count);
-int rebuild_headlines(struct Config *config, SDL_Renderer *renderer, TTF_Font *font, struct NewsLine *news_lines, int screen_width, int screen_height, const char *config_error_message, char *status_out, size_t status_len, bool *used_fallback_out);
-static int fetch_newsapi_headlines(const struct Config *config, SDL_Renderer *renderer, TTF_Font *font, struct NewsLine *news_lines, int screen_width, int screen_height, int *y_cursor, char *fetch_error, size_t fetch_error_len);
+void rng_seed(struct Rng *rng, Uint64 seed, Uint64 stream);
+Uint32 rng_next(struct Rng *rng);
+float rng_unit(struct Rng *rng);
+Uint32 rng_below(struct Rng *rng, Uint32 bound);
+bool init_lane_pool(struct LanePool *pool, TTF_Font *font, SDL_Rect area, Uint64 seed, int stream, const struct Config *config);
+void destroy_lane_pool(struct LanePool *pool);
+bool relayout_lane_pool(struct LanePool *pool, TTF_Font *font, struct HeadlineStore *store, const struct Config *config);
+static float random_speed(struct LanePool *pool, const struct Config *config);
+static bool rasterize_news_line(struct TextRenderer *text_renderer, struct NewsLine *line);
+static void release_lane(struct LanePool *pool, int lane);
+static void spawn_news_line(struct LanePool *pool, int lane, const struct Config *config);
+static bool assign_lane(struct LanePool *pool, int lane, struct HeadlineStore *store, int index, const struct Config *config);
+static int next_free_headline(struct HeadlineStore *store);
+void fill_empty_lanes(struct LanePool *pool, struct HeadlineStore *store, const struct Config *config);
+void attach_headline_store(struct LanePool *pool, struct HeadlineStore *store, bool restart);
+void refill_lanes(struct LanePool *pool, struct HeadlineStore *store, struct TextRenderer *text_renderer, float lookahead, const struct Config *config);
+static bool store_add_headline(struct HeadlineStore *store, char *text, SDL_Color color);
+static bool inject_headline(struct HeadlineStore *store, struct FontChain *fonts, const char *text, bool repeat, const struct Config *config);
+Uint64 headline_identity(const char *text);
+static int find_headline(const struct HeadlineStore *store, Uint64 identity);
+static bool headlines_unchanged(const struct HeadlineStore *current, const struct HeadlineStore *next);
+static bool index_headline(struct HeadlineStore *store, int index);
+static void reindex_headlines(struct HeadlineStore *store);
+static int oldest_injected_headline(const struct HeadlineStore *store);
+static void drop_headline_text(struct HeadlineStore *store, int index);
+static void carry_injected_headlines(struct HeadlineStore *store, const struct HeadlineStore *previous);
+void reset_headline_store(struct HeadlineStore *store);
+void free_headline_store(struct HeadlineStore *store);
+int build_headline_store(struct Config *config, struct TextRenderer *text_renderer, struct HeadlineStore *store, const struct HeadlineStore *previous, struct HeadlineBatch *batch, const char *config_error_message, char *status_out, size_t status_len);
+static int fetch_feed_sources(struct FetchWorker *worker, struct HeadlineBatch *batch);
+static int configure_feed_sources(struct FetchWorker *worker);
+static bool start_feed_transfer(struct FetchWorker *worker, struct FeedSource *source);
+static void run_feed_transfers(struct FetchWorker *worker);
+static void complete_feed_transfer(struct FeedSource *source, CURLcode result);
+static int merge_feed_sources(struct FetchWorker *worker, struct HeadlineBatch *batch);
+static void newsapi_url(const struct Config *config, char *url, size_t url_len);
+static void guardian_url(const struct Config *config, char *url, size_t url_len);
+static int parse_feed_body(struct FeedSource *source, const char *body, size_t len, struct HeadlineBatch *batch);
+static void begin_feed_scan(struct FeedSource *source, struct HeadlineBatch *batch);
+static void collect_batch_title(void *ctx, const char *title);
+static int finish_feed_scan(struct FeedSource *source, struct HeadlineBatch *batch);
+static void clear_batch_titles(struct HeadlineBatch *batch);
+static bool batch_add_title(struct HeadlineBatch *batch, char *title);
+static void release_batch_storage(struct HeadlineBatch *batch);
+static size_t FeedWriteCallback(void *contents, size_t size, size_t nmemb, void *userp);
+void json_scanner_init(struct JsonStreamScanner *scanner, const struct JsonFeedSchema *schema, void (*on_title)(void *ctx, const char *title), void *ctx);
+bool json_scanner_feed(struct JsonStreamScanner *scanner, const char *data, size_t len);
+bool json_scanner_finish(struct JsonStreamScanner *scanner);
+void json_scanner_free(struct JsonStreamScanner *scanner);
+void rss_scanner_init(struct RssStreamScanner *scanner, void (*on_title)(void *ctx, const char *title), void *ctx);
+bool rss_scanner_feed(struct RssStreamScanner *scanner, const char *data, size_t len);
+bool rss_scanner_finish(struct RssStreamScanner *scanner);
+static size_t encode_utf8(Uint32 cp, char *out);
+static size_t HeaderCallback(char *buffer, size_t size, size_t nitems, void *userp);
+static bool load_response_cache(struct FeedSource *source, struct MemoryStruct *body);
+static void save_response_cache(const struct FeedSource *source, const char *body, size_t len);
+static bool load_cached_headlines(struct FetchWorker *worker, struct HeadlineBatch *batch);
+static Uint64 hash_bytes(const void *data, size_t len, Uint64 hash);
+bool init_glyph_atlas(struct GlyphAtlas *atlas, SDL_Renderer *renderer, TTF_Font *font);
+void destroy_glyph_atlas(struct GlyphAtlas *atlas);
+static const struct AtlasGlyph *atlas_glyph(struct GlyphAtlas *atlas, struct FontChain *fonts, int font, Uint32 codepoint);
+bool layout_atlas_text(struct TextRenderer *text_renderer, struct NewsLine *line);
+void draw_news_lines(struct TextRenderer *text_renderer, const struct LanePool *pool, float alpha);
+static bool news_line_has_content(const struct NewsLine *line);
+static Uint64 texture_cache_key(const char *text, SDL_Color color, int font_size);
+bool acquire_cached_texture(struct TextRenderer *text_renderer, struct NewsLine *line);
+void trim_texture_cache(struct TextureCache *cache);
+static int evict_cached_textures(struct TextureCache *cache, size_t target_bytes);
+size_t texture_bytes_in_use(const struct TextRenderer *text_renderer);
+static size_t estimate_line_bytes(struct TextRenderer *text_renderer, const struct NewsLine *line);
+static bool make_texture_room(struct TextRenderer *text_renderer, struct LanePool *pool, size_t bytes, float raster_edge);
+static void account_line_texture(struct TextRenderer *text_renderer, struct NewsLine *line);
+static size_t line_owned_bytes(const struct NewsLine *line);
+static void recover_texture_limit(struct TextureBudget *budget);
+SDL_Color headline_color(const struct Config *config, const char *text);
+void destroy_texture_cache(struct TextureCache *cache);
+bool start_fetch_worker(struct FetchWorker *worker, const struct Config *config);
+void stop_fetch_worker(struct FetchWorker *worker);
+void request_refresh(struct FetchWorker *worker);
+struct HeadlineBatch *take_headline_batch(struct FetchWorker *worker);
+void free_headline_batch(struct HeadlineBatch *batch);
+static int fetch_worker_main(void *data);
+static bool fetch_worker_sleep(struct FetchWorker *worker, Uint32 ms);
+static bool wait_for_refresh(struct FetchWorker *worker, Uint32 ms);
+static bool start_push_source(struct FetchWorker *worker);
+static void stop_push_source(struct FetchWorker *worker);
+static int push_worker_main(void *data);
+static bool read_push_stream(struct FetchWorker *worker, struct PushReader *reader);
+static bool read_push_pipe(struct FetchWorker *worker, struct PushReader *reader);
+static size_t PushWriteCallback(void *contents, size_t size, size_t nmemb, void *userp);
+static void feed_push_bytes(struct PushReader *reader, const char *bytes, size_t len);
+static void end_push_line(struct PushReader *reader);
+static void deliver_pushed_headline(struct PushReader *reader, const char *payload);
+static int fetch_abort_callback(void *clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow);
+static CURL *feed_source_handle(struct FetchWorker *worker, struct FeedSource *source);
+static void release_fetch_handles(struct FetchWorker *worker);
+struct RefreshMetrics *take_refresh_metrics(struct FetchWorker *worker);
+static void publish_refresh_metrics(struct FetchWorker *worker, double total_ms);
+static void record_source_timing(struct FeedSource *source, bool ok);
+static double ticks_to_ms(Uint64 ticks);
+void init_frame_stats(struct FrameStats *stats, int refresh_rate);
+void record_frame(struct FrameStats *stats, const struct FrameSample *sample);
+void summarize_frames(const struct FrameStats *stats, int frames, struct FrameSummary *summary);
+void init_frame_pacer(struct FramePacer *pacer, const struct Config *config, int refresh_rate, SDL_Renderer *renderer);
+Uint32 pacing_wait_ms(const struct FramePacer *pacer);
+double pacing_target_ms(const struct FramePacer *pacer);
+void pace_frame(struct FramePacer *pacer, Uint64 presented, float frame_ms, float fastest_speed);
+static bool news_lines_moving(const struct LanePool *pool);
+Uint32 idle_wait_ms(const struct Hud *hud, const struct TelemetryLog *telemetry, Uint32 next_telemetry);
+bool open_telemetry_log(struct TelemetryLog *log, const struct Config *config);
+void close_telemetry_log(struct TelemetryLog *log);
+static void write_telemetry_line(struct TelemetryLog *log, const char *line);
+static void write_telemetry_json(struct TelemetryLog *log, cJSON *record, const char *kind);
+void log_frame_telemetry(struct TelemetryLog *log, const struct FrameSummary *summary);
+void log_refresh_telemetry(struct TelemetryLog *log, const struct RefreshMetrics *metrics);
+void log_rebuild_telemetry(struct TelemetryLog *log, int lines, double rasterize_ms, int cache_hits, int cache_misses);
+void log_texture_telemetry(struct TelemetryLog *log, const struct TextureBudget *totals, size_t bytes);
+void update_hud(struct Hud *hud, SDL_Renderer *renderer, const struct FrameStats *stats, int screen_width);
+void draw_hud(const struct Hud *hud, SDL_Renderer *renderer);
+void destroy_hud(struct Hud *hud);
+bool parse_arguments(int argc, char *argv[], struct LaunchOptions *options);
+int run_benchmark(struct Config *config, const struct LaunchOptions *options);
+static bool read_file(const char *path, struct MemoryStruct *out);
+static double peak_rss_mb(void);
+static float percentile(const float *sorted, int count, float fraction);
+TTF_Font *open_font_with_fallback(const char *path, int size, const char **opened_path);
+void init_text_renderer(struct TextRenderer *text_renderer, SDL_Renderer *renderer, struct FontChain *fonts, const struct Config *config);
+static bool open_ticker_window(struct TickerWindow *ticker, SDL_Rect bounds, Uint32 flags, bool vsync, struct FontChain *fonts, const struct Config *config);
+int open_ticker_windows(struct TickerWindow *windows, struct FontChain *fonts, Uint64 seed, const struct Config *config);
+void close_ticker_windows(struct TickerWindow *windows, int count);
+static bool windows_moving(const struct TickerWindow *windows, int count);
+static float fastest_lane_speed(const struct TickerWindow *windows, int count);
+static bool lanes_showing(const struct TickerWindow *windows, int count);
+static int count_lanes(const struct TickerWindow *windows, int count);
+void attach_windows(struct TickerWindow *windows, int count, struct HeadlineStore *store, bool restart, const struct Config *config);
+static void fill_window_lanes(struct TickerWindow *windows, int count, struct HeadlineStore *store, const struct Config *config);
+static void sum_texture_caches(const struct TickerWindow *windows, int count, struct TextureCache *totals);
+static size_t sum_texture_budgets(const struct TickerWindow *windows, int count, struct TextureBudget *totals);
+void update_news_lines(struct LanePool *pool, float step_seconds);
+int drain_scroll_steps(double *accumulator, float *alpha);
+void step_news_lines(struct LanePool *pool, int steps);
+bool start_control_worker(struct ControlWorker *worker, const struct Config *config, struct FetchWorker *fetch);
+void stop_control_worker(struct ControlWorker *worker);
+static int control_worker_main(void *data);
+static void handle_control_request(struct ControlWorker *worker, struct ControlRequest *request);
+static bool push_control_command(struct CommandQueue *queue, const struct ControlCommand *command);
+static bool pop_control_command(struct CommandQueue *queue, struct ControlCommand *command);
+void publish_control_metrics(struct MetricsBoard *board, const struct ControlMetrics *metrics);
+static void read_control_metrics(struct MetricsBoard *board, struct ControlMetrics *metrics);
+static size_t format_control_metrics(const struct ControlMetrics *metrics, char *buffer, size_t size);
+static void append_format(char *buffer, size_t size, size_t *used, const char *format, ...);
 
 
 // --- Main Function ---
 int main(int argc, char* argv[]) {
-    srand(time(NULL));
+    struct LaunchOptions options;
+    if (!parse_arguments(argc, argv, &options)) {
+        return 2;
+    }
+    if (!options.has_seed) {
+        options.seed = (Uint64)time(NULL) ^ SDL_GetPerformanceCounter();
+    }
 
     // --- Load Configuration ---
     struct Config config;
@@ -106,6 +1027,10 @@ int main(int argc, char* argv[]) {
         fprintf(stderr, "%s\n", config_error);
     }
 
+    if (options.bench) {
+        return run_benchmark(&config, &options);
+    }
+
     // --- SDL & TTF Initialization ---
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         fprintf(stderr, "SDL could not initialize! SDL_Error: %s\n", SDL_GetError());
@@ -116,105 +1041,342 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    Uint64 launch_counter = SDL_GetPerformanceCounter();
+
+    // Before any thread starts, since curl_global_init can't run alongside other threads; the slow TLS
+    // and resolver work waits for the worker's first transfer
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    // Network I/O lives on its own thread so curl timeouts and retry backoff never stall a frame.
+    // Started first: the cached headlines load while the font and windows open.
+    struct FetchWorker fetch_worker;
+    if (!start_fetch_worker(&fetch_worker, &config)) {
+        fprintf(stderr, "Unable to start fetch worker: %s\n", SDL_GetError());
+        struct HeadlineBatch *failed = calloc(1, sizeof(*failed));
+        if (failed) {
+            snprintf(failed->error, sizeof(failed->error), "Background fetch unavailable.");
+            SDL_AtomicSetPtr(&fetch_worker.ready, failed);
+        }
+    }
+
     SDL_DisplayMode dm;
     SDL_GetDesktopDisplayMode(0, &dm);
-    int SCREEN_WIDTH = dm.w;
-    int SCREEN_HEIGHT = dm.h;
 
-    SDL_Window* window = SDL_CreateWindow("News Ticker", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_FULLSCREEN_DESKTOP);
-    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    const char *font_file = NULL;
+    struct FontChain fonts;
+    if (!open_font_chain(&fonts, &config, &font_file)) {
+        stop_fetch_worker(&fetch_worker);
+        curl_global_cleanup();
+        return 1; // Exit if no font can be loaded
+    }
+    if (fonts.count > 1) {
+        fprintf(stdout, "Using %d fallback fonts for characters %s lacks.\n", fonts.count - 1, font_file);
+    }
+    struct LineSnapshot line_snapshot;
+    open_line_snapshot(&line_snapshot, font_file, fonts.fonts[0], &config);
 
-    TTF_Font* font = TTF_OpenFont(config.font_path, config.font_size);
-    if (!font) {
-        fprintf(stderr, "Failed to load font: %s! TTF_Error: %s\n", config.font_path, TTF_GetError());
-        // Try a common system font as a last resort
-        #ifdef _WIN32
-        font = TTF_OpenFont("C:/Windows/Fonts/Arial.ttf", config.font_size);
-        #else
-        font = TTF_OpenFont("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", config.font_size);
-        #endif
-        if (!font) return 1; // Exit if no font can be loaded
+    // Lines sit at fractional x positions; linear sampling turns that into smooth motion instead of pixel snapping
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
+    struct TickerWindow windows[MAX_DISPLAYS];
+    // Printed so a layout worth investigating can be replayed with --seed
+    fprintf(stdout, "Layout seed %llu.\n", (unsigned long long)options.seed);
+    int window_count = open_ticker_windows(windows, &fonts, options.seed, &config);
+    if (window_count == 0) {
+        stop_fetch_worker(&fetch_worker);
+        curl_global_cleanup();
+        close_line_snapshot(&line_snapshot);
+        return 1;
+    }
+    // Atlas mode draws glyphs, not lines, so it has nothing to snapshot
+    for (int w = 0; w < window_count; ++w) {
+        if (windows[w].text_renderer.mode != TEXT_RENDER_ATLAS) windows[w].text_renderer.snapshot = &line_snapshot;
     }
+    // The HUD lives on the first window
+    SDL_Renderer *renderer = windows[0].renderer;
+    struct TextRenderer *font_renderer = &windows[0].text_renderer;
 
     // --- Data Structures for News ---
-    struct NewsLine news_lines[MAX_LINES] = {0};
-    int num_headlines = 0;
-    bool used_fallback = false;
-    char load_status[STATUS_BUFFER] = {0};
-
-    num_headlines = rebuild_headlines(&config, renderer, font, news_lines, SCREEN_WIDTH, SCREEN_HEIGHT, config_error, load_status, sizeof(load_status), &used_fallback);
-    if (load_status[0]) {
-        fprintf(stdout, "%s\n", load_status);
-    }
+    // Lanes draw from the front store while the back store is built; they swap at a frame boundary.
+    // Every display's lanes share the store, so no two screens show the same headline at once.
+    struct HeadlineStore stores[2] = {0};
+    struct HeadlineStore *front_store = &stores[0];
+    struct HeadlineStore *back_store = &stores[1];
 
-    Uint32 refresh_interval_ms = (Uint32)config.refresh_interval_seconds * 1000;
-    Uint32 last_refresh_ticks = SDL_GetTicks();
+    // --- Instrumentation ---
+    struct FrameStats frame_stats;
+    init_frame_stats(&frame_stats, dm.refresh_rate);
+    struct FramePacer pacer;
+    init_frame_pacer(&pacer, &config, dm.refresh_rate, renderer);
+    struct TelemetryLog telemetry;
+    open_telemetry_log(&telemetry, &config);
+    struct Hud hud = { .visible = config.show_hud };
+    hud.font = TTF_OpenFont(font_file, HUD_FONT_SIZE);
+    Uint32 next_telemetry = SDL_GetTicks() + TELEMETRY_INTERVAL_MS;
+    struct ConfigWatch config_watch;
+    watch_config_file(&config_watch);
+    // Commands reach the loop through a queue drained once per iteration; metrics go out once a second
+    struct ControlWorker control;
+    start_control_worker(&control, &config, &fetch_worker);
+    Uint32 next_control_publish = 0;
+    Uint64 cache_hits_total = 0;
+    Uint64 cache_misses_total = 0;
+    int refresh_count = 0;
 
     // --- Main Loop ---
     bool is_running = true;
     bool is_paused = false;
-    Uint32 last_ticks = SDL_GetTicks();
+    bool first_frame = true;
+    bool needs_redraw = true; // Set by anything that changes the picture while nothing scrolls
+    Uint64 last_counter = SDL_GetPerformanceCounter();
+    double scroll_accumulator = 0.0;
+    float scroll_alpha = 0.0f;
+    Uint64 last_present = SDL_GetPerformanceCounter();
     while (is_running) {
         SDL_Event e;
-        while (SDL_PollEvent(&e) != 0) {
+        bool have_event = SDL_PollEvent(&e) != 0;
+        if (!have_event && config.idle_when_static && !needs_redraw && (is_paused || !windows_moving(windows, window_count))) {
+            // The last presented frame is still correct; sleep until input or the next timed job
+            have_event = SDL_WaitEventTimeout(&e, (int)idle_wait_ms(&hud, &telemetry, next_telemetry)) != 0;
+        } else if (!have_event) {
+            // Between paced presents; input still wakes the loop at once
+            Uint32 pace_wait = pacing_wait_ms(&pacer);
+            if (pace_wait > 0) have_event = SDL_WaitEventTimeout(&e, (int)pace_wait) != 0;
+        }
+        for (; have_event; have_event = SDL_PollEvent(&e) != 0) {
             if (e.type == SDL_QUIT) is_running = false;
             if (e.type == SDL_KEYDOWN) {
                 if (e.key.keysym.sym == SDLK_ESCAPE) is_running = false;
                 if (e.key.keysym.sym == SDLK_SPACE) is_paused = !is_paused;
+                if (e.key.keysym.sym == SDLK_h) {
+                    hud.visible = !hud.visible;
+                    hud.next_update = 0;
+                }
+                needs_redraw = true;
+            }
+            // Exposure, restores and lost render targets leave the backbuffer stale
+            if (e.type == SDL_WINDOWEVENT || e.type == SDL_RENDER_TARGETS_RESET || e.type == SDL_RENDER_DEVICE_RESET) {
+                needs_redraw = true;
             }
         }
 
-        Uint32 current_ticks = SDL_GetTicks();
+        struct ControlCommand command;
+        while (pop_control_command(&control.commands, &command)) {
+            if (command.kind == CONTROL_INJECT) {
+                if (inject_headline(front_store, &fonts, command.text, true, &config)) {
+                    fill_window_lanes(windows, window_count, front_store, &config);
+                }
+            } else {
+                is_paused = command.kind == CONTROL_PAUSE;
+            }
+            needs_redraw = true;
+        }
+        // Pushed stories join the set on screen one at a time; only polled refreshes rebuild it
+        while (pop_control_command(&fetch_worker.pushed, &command)) {
+            if (inject_headline(front_store, &fonts, command.text, false, &config)) {
+                fill_window_lanes(windows, window_count, front_store, &config);
+                needs_redraw = true;
+            }
+        }
 
-        if (refresh_interval_ms > 0 && SDL_TICKS_PASSED(current_ticks, last_refresh_ticks + refresh_interval_ms)) {
-            bool refresh_fallback = false;
-            char refresh_status[STATUS_BUFFER] = {0};
-            num_headlines = rebuild_headlines(&config, renderer, font, news_lines, SCREEN_WIDTH, SCREEN_HEIGHT, config_error, refresh_status, sizeof(refresh_status), &refresh_fallback);
-            last_refresh_ticks = SDL_GetTicks();
-            last_ticks = last_refresh_ticks;
-            current_ticks = last_refresh_ticks;
-            if (refresh_status[0]) {
-                fprintf(stdout, "%s\n", refresh_status);
+        if (poll_config_file(&config_watch)) {
+            struct Config next_config;
+            if (!parse_config(&next_config, config_error, sizeof(config_error)) && config_error[0] != '\0') {
+                fprintf(stderr, "%s\n", config_error);
             }
+            apply_config_reload(&config, &next_config, windows, window_count, front_store, &hud, &line_snapshot, &fonts, &font_file);
+            last_counter = SDL_GetPerformanceCounter();
+            needs_redraw = true;
+        }
+
+        struct RefreshMetrics *refresh_metrics = take_refresh_metrics(&fetch_worker);
+        if (refresh_metrics) {
+            log_refresh_telemetry(&telemetry, refresh_metrics);
+            hud.refresh = *refresh_metrics;
+            hud.has_refresh = true;
+            refresh_count++;
+            free(refresh_metrics);
         }
 
-        float delta_seconds = 0.0f;
-        if (!is_paused) {
-            delta_seconds = (current_ticks - last_ticks) / 1000.0f;
+        struct HeadlineBatch *batch = take_headline_batch(&fetch_worker);
+        if (batch && batch->count == 0 && front_store->count > 0 && !front_store->used_fallback) {
+            // A failed refresh keeps the current lines rather than rasterizing fallbacks over them;
+            // fallbacks themselves are rebuilt, so their status line names the latest failure
+            fprintf(stderr, "Refresh failed (%s); keeping current headlines.\n", batch->error[0] ? batch->error : "no headlines");
+            free_headline_batch(batch);
+        } else if (batch) {
+            char load_status[STATUS_BUFFER] = {0};
+            Uint64 rebuild_start = SDL_GetPerformanceCounter();
+            build_headline_store(&config, font_renderer, back_store, front_store, batch, config_error, load_status, sizeof(load_status));
+            if (headlines_unchanged(front_store, back_store)) {
+                // Same stories as on screen: every lane, texture and rotation position stays as it is
+                fprintf(stdout, "Refresh brought no new headlines; keeping the current set.\n");
+                free_headline_batch(batch);
+                reset_headline_store(back_store);
+            } else {
+                // Fallback lines make way at once; real headlines already on screen finish their pass
+                bool restart = front_store->used_fallback || front_store->count == 0;
+                attach_windows(windows, window_count, back_store, restart, &config);
+                if (font_renderer->snapshot && !back_store->used_fallback) {
+                    plan_line_snapshot(&line_snapshot, windows, window_count, config.font_size);
+                }
+                struct TextureCache cache_totals = {0};
+                sum_texture_caches(windows, window_count, &cache_totals);
+                hud.rasterize_ms = ticks_to_ms(SDL_GetPerformanceCounter() - rebuild_start);
+                hud.rebuild_lines = back_store->count;
+                hud.rebuild_diff = back_store->diff;
+                log_rebuild_telemetry(&telemetry, back_store->count, hud.rasterize_ms, cache_totals.hits, cache_totals.misses);
+                free_headline_batch(batch);
+
+                struct HeadlineStore *retired = front_store;
+                front_store = back_store;
+                back_store = retired;
+                reset_headline_store(back_store);
+                if (font_renderer->cache.budget_bytes > 0) {
+                    for (int w = 0; w < window_count; ++w) {
+                        trim_texture_cache(&windows[w].text_renderer.cache);
+                    }
+                    sum_texture_caches(windows, window_count, &cache_totals);
+                    if (options.verbose) {
+                        fprintf(stdout, "Texture cache: %d reused, %d rasterized, %.1f MB resident.\n", cache_totals.hits, cache_totals.misses, cache_totals.bytes / (1024.0 * 1024.0));
+                    }
+                    cache_hits_total += (Uint64)cache_totals.hits;
+                    cache_misses_total += (Uint64)cache_totals.misses;
+                    for (int w = 0; w < window_count; ++w) {
+                        windows[w].text_renderer.cache.hits = 0;
+                        windows[w].text_renderer.cache.misses = 0;
+                    }
+                }
+
+                // Rasterizing can take a few frames; don't let it turn into a scroll jump
+                last_counter = SDL_GetPerformanceCounter();
+                needs_redraw = true;
+                if (load_status[0]) {
+                    fprintf(stdout, "%s\n", load_status);
+                }
+            }
         }
-        last_ticks = current_ticks;
+
+        Uint64 current_counter = SDL_GetPerformanceCounter();
+        double elapsed_seconds = ticks_to_ms(current_counter - last_counter) / 1000.0;
+        last_counter = current_counter;
 
         // --- Update ---
-        if (!is_paused) {
-            for (int i = 0; i < num_headlines; ++i) {
-                if (!news_lines[i].texture) continue;
-                news_lines[i].scroll_x -= news_lines[i].scroll_speed * delta_seconds;
-                if (news_lines[i].scroll_x < -news_lines[i].texture_width) {
-                    news_lines[i].scroll_x = SCREEN_WIDTH + (rand() % 500);
+        Uint64 update_start = SDL_GetPerformanceCounter();
+        if (!is_paused && windows_moving(windows, window_count)) {
+            // Pausing freezes the accumulator too, so the frozen frame keeps its interpolated position
+            scroll_accumulator += elapsed_seconds;
+            int steps = drain_scroll_steps(&scroll_accumulator, &scroll_alpha);
+            for (int w = 0; w < window_count; ++w) {
+                for (int p = 0; p < windows[w].pool_count; ++p) {
+                    step_news_lines(&windows[w].pools[p], steps);
+                    // Lanes rasterize as they reach the right edge, so the headline count never sets the texture count
+                    refill_lanes(&windows[w].pools[p], front_store, &windows[w].text_renderer, 0.0f, &config);
                 }
             }
+            needs_redraw = true;
         }
 
         // --- Drawing ---
-        SDL_SetRenderDrawColor(renderer, config.background_color.r, config.background_color.g, config.background_color.b, 255);
-        SDL_RenderClear(renderer);
+        bool frame_wanted = needs_redraw || !config.idle_when_static;
+        if (frame_wanted && pacing_wait_ms(&pacer) == 0) {
+            Uint64 render_start = SDL_GetPerformanceCounter();
+            Uint64 present_ticks = 0;
+            for (int w = 0; w < window_count; ++w) {
+                struct TickerWindow *ticker = &windows[w];
+                SDL_SetRenderDrawColor(ticker->renderer, config.background_color.r, config.background_color.g, config.background_color.b, 255);
+                SDL_RenderClear(ticker->renderer);
+                for (int p = 0; p < ticker->pool_count; ++p) {
+                    draw_news_lines(&ticker->text_renderer, &ticker->pools[p], scroll_alpha);
+                }
+                if (w == 0) draw_hud(&hud, renderer);
 
-        for (int i = 0; i < num_headlines; ++i) {
-            if (!news_lines[i].texture) continue;
-            SDL_Rect dstRect = { (int)news_lines[i].scroll_x, news_lines[i].y_position, news_lines[i].texture_width, news_lines[i].texture_height };
-            SDL_RenderCopy(renderer, news_lines[i].texture, NULL, &dstRect);
+                Uint64 present_start = SDL_GetPerformanceCounter();
+                SDL_RenderPresent(ticker->renderer);
+                present_ticks += SDL_GetPerformanceCounter() - present_start;
+            }
+            Uint64 frame_end = SDL_GetPerformanceCounter();
+
+            struct FrameSample sample = {
+                .update_ms = (float)ticks_to_ms(render_start - update_start),
+                .render_ms = (float)ticks_to_ms(frame_end - render_start - present_ticks),
+                .present_ms = (float)ticks_to_ms(present_ticks),
+                .frame_ms = (float)ticks_to_ms(frame_end - last_present),
+                .target_ms = (float)pacing_target_ms(&pacer)
+            };
+            last_present = frame_end;
+            record_frame(&frame_stats, &sample);
+            pace_frame(&pacer, frame_end, sample.frame_ms, is_paused ? 0.0f : fastest_lane_speed(windows, window_count));
+            if (first_frame && lanes_showing(windows, window_count)) {
+                fprintf(stdout, "First headlines on screen %.1f ms after launch.\n", ticks_to_ms(frame_end - launch_counter));
+                first_frame = false;
+            }
+            needs_redraw = false;
+            settle_line_snapshot(&line_snapshot, windows, window_count);
+            flush_line_snapshot(&line_snapshot);
+        } else if (!frame_wanted) {
+            // Time spent idle isn't a late frame
+            last_present = SDL_GetPerformanceCounter();
         }
 
-        SDL_RenderPresent(renderer);
+        Uint32 now = SDL_GetTicks();
+        if (telemetry.file && SDL_TICKS_PASSED(now, next_telemetry)) {
+            struct FrameSummary summary;
+            summarize_frames(&frame_stats, frame_stats.unlogged, &summary);
+            log_frame_telemetry(&telemetry, &summary);
+            struct TextureBudget texture_totals;
+            size_t texture_bytes = sum_texture_budgets(windows, window_count, &texture_totals);
+            log_texture_telemetry(&telemetry, &texture_totals, texture_bytes);
+            frame_stats.unlogged = 0;
+            next_telemetry = now + TELEMETRY_INTERVAL_MS;
+        }
+        if (control.thread && SDL_TICKS_PASSED(now, next_control_publish)) {
+            struct ControlMetrics metrics = {0};
+            summarize_frames(&frame_stats, frame_stats.count, &metrics.frames);
+            metrics.missed_presents = pacer.missed_total;
+            metrics.refresh = hud.refresh;
+            metrics.has_refresh = hud.has_refresh;
+            metrics.refreshes = refresh_count;
+            struct TextureCache cache_totals;
+            sum_texture_caches(windows, window_count, &cache_totals);
+            metrics.cache_hits = cache_hits_total + (Uint64)cache_totals.hits;
+            metrics.cache_misses = cache_misses_total + (Uint64)cache_totals.misses;
+            metrics.texture_bytes = sum_texture_budgets(windows, window_count, &metrics.textures);
+            metrics.shape_hits = fonts.shape_hits;
+            metrics.shape_misses = fonts.shape_misses;
+            metrics.headlines = front_store->used_fallback ? 0 : front_store->count;
+            metrics.paused = is_paused;
+            metrics.uptime_seconds = ticks_to_ms(SDL_GetPerformanceCounter() - launch_counter) / 1000.0;
+            publish_control_metrics(&control.board, &metrics);
+            next_control_publish = now + TELEMETRY_INTERVAL_MS;
+        }
+        if (hud.visible && SDL_TICKS_PASSED(now, hud.next_update)) {
+            // Next frame shows it; rendering a small texture twice a second is noise in the numbers it reports
+            hud.texture_bytes = sum_texture_budgets(windows, window_count, &hud.textures);
+            hud.paced_fps = (float)(1000.0 / pacing_target_ms(&pacer));
+            update_hud(&hud, renderer, &frame_stats, windows[0].width);
+            hud.next_update = now + HUD_UPDATE_MS;
+            needs_redraw = true;
+        }
     }
 
     // --- Cleanup ---
-    for (int i = 0; i < MAX_LINES; ++i) {
-        release_news_line(&news_lines[i]);
+    stop_control_worker(&control);
+    stop_fetch_worker(&fetch_worker);
+    curl_global_cleanup();
+    for (int i = 0; i < 2; ++i) {
+        free_headline_store(&stores[i]);
+    }
+    destroy_hud(&hud);
+    close_ticker_windows(windows, window_count);
+    if (line_snapshot.hits > 0) {
+        fprintf(stdout, "Snapshot supplied %d line textures.\n", line_snapshot.hits);
     }
-    TTF_CloseFont(font);
-    SDL_DestroyRenderer(renderer);
-    SDL_DestroyWindow(window);
+    if (pacer.missed_total > 0) {
+        fprintf(stdout, "Missed %d paced presents.\n", pacer.missed_total);
+    }
+    close_line_snapshot(&line_snapshot);
+    close_telemetry_log(&telemetry);
+    close_font_chain(&fonts);
     TTF_Quit();
     SDL_Quit();
     return 0;
@@ -222,506 +1384,4904 @@ int main(int argc, char* argv[]) {
 
 // --- Function Implementations ---
 
-void render_text(SDL_Renderer* renderer, TTF_Font* font, struct NewsLine* line) {
-    if (line->texture) {
-        SDL_DestroyTexture(line->texture);
-    }
-    SDL_Surface* surface = TTF_RenderText_Blended(font, line->text, line->color);
-    if (surface) {
-        line->texture = SDL_CreateTextureFromSurface(renderer, surface);
-        line->texture_width = surface->w;
-        line->texture_height = surface->h;
-        SDL_FreeSurface(surface);
-    } else {
-        line->texture = NULL;
-        line->texture_width = 0;
-        line->texture_height = 0;
+TTF_Font *open_font_with_fallback(const char *path, int size, const char **opened_path) {
+    TTF_Font *font = TTF_OpenFont(path, size);
+    if (!font) {
+        fprintf(stderr, "Failed to load font: %s! TTF_Error: %s\n", path, TTF_GetError());
+        // Try a common system font as a last resort
+        #ifdef _WIN32
+        path = "C:/Windows/Fonts/Arial.ttf";
+        #else
+        path = "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf";
+        #endif
+        font = TTF_OpenFont(path, size);
     }
+    if (opened_path) *opened_path = font ? path : NULL;
+    return font;
 }
 
-void trim_whitespace(char *str) {
-    if (!str) return;
-    char *start = str;
-    while (isspace((unsigned char)*start)) {
-        start++;
+void init_text_renderer(struct TextRenderer *text_renderer, SDL_Renderer *renderer, struct FontChain *fonts, const struct Config *config) {
+    memset(text_renderer, 0, sizeof(*text_renderer));
+    text_renderer->renderer = renderer;
+    text_renderer->fonts = fonts;
+    text_renderer->font = fonts->fonts[0];
+    text_renderer->font_size = config->font_size;
+    text_renderer->mode = config->text_render_mode;
+    text_renderer->cache.budget_bytes = (size_t)config->texture_cache_mb * 1024 * 1024;
+    text_renderer->budget.limit_bytes = (size_t)config->texture_budget_mb * 1024 * 1024;
+    text_renderer->budget.configured_bytes = text_renderer->budget.limit_bytes;
+    text_renderer->tile_width = LINE_TILE_WIDTH;
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(renderer, &info) == 0 && info.max_texture_width > 0) {
+        text_renderer->max_texture_width = info.max_texture_width;
+        if (info.max_texture_width < text_renderer->tile_width) text_renderer->tile_width = info.max_texture_width;
     }
-
-    memmove(str, start, strlen(start) + 1);
-
-    char *end = str + strlen(str) - 1;
-    while (end >= str && isspace((unsigned char)*end)) {
-        end--;
+    if (text_renderer->mode == TEXT_RENDER_ATLAS && !init_glyph_atlas(&text_renderer->atlas, renderer, text_renderer->font)) {
+        fprintf(stderr, "Glyph atlas unavailable (%s); using per-line textures.\n", SDL_GetError());
+        text_renderer->mode = TEXT_RENDER_TEXTURE;
     }
-    *(end + 1) = '\0';
 }
 
-
-bool parse_config(struct Config* config, char *error_message, size_t message_len) {
-    if (error_message && message_len > 0) {
-        error_message[0] = '\0';
+static bool open_ticker_window(struct TickerWindow *ticker, SDL_Rect bounds, Uint32 flags, bool vsync, struct FontChain *fonts, const struct Config *config) {
+    memset(ticker, 0, sizeof(*ticker));
+    ticker->width = bounds.w;
+    ticker->height = bounds.h;
+    ticker->window = SDL_CreateWindow("News Ticker", bounds.x, bounds.y, bounds.w, bounds.h, flags);
+    if (!ticker->window) return false;
+    ticker->renderer = SDL_CreateRenderer(ticker->window, -1, SDL_RENDERER_ACCELERATED | (vsync ? SDL_RENDERER_PRESENTVSYNC : 0));
+    if (!ticker->renderer) {
+        // Signage boxes without a GPU driver still get a ticker; the pacer tunes itself for it
+        fprintf(stderr, "No accelerated renderer (%s); using software rendering.\n", SDL_GetError());
+        ticker->renderer = SDL_CreateRenderer(ticker->window, -1, SDL_RENDERER_SOFTWARE);
     }
-
-    // Set defaults first
-    strcpy(config->api_key, "YOUR_API_KEY");
-    strcpy(config->font_path, "font.ttf");
-    strcpy(config->country_code, "us"); // Default to US
-    config->font_size = 28;
-    config->refresh_interval_seconds = DEFAULT_REFRESH_INTERVAL_SECONDS;
-    config->line_padding = DEFAULT_LINE_PADDING;
-    config->scroll_speed_min = DEFAULT_SCROLL_SPEED_MIN;
-    config->scroll_speed_max = DEFAULT_SCROLL_SPEED_MAX;
-    config->background_color = (SDL_Color){20, 20, 20, 255};
-    config->colors[0] = (SDL_Color){255, 165, 0, 255}; // Amber
-    config->colors[1] = (SDL_Color){0, 255, 255, 255};   // Cyan
-    config->colors[2] = (SDL_Color){255, 255, 0, 255};   // Yellow
-    config->colors[3] = (SDL_Color){0, 255, 0, 255};     // Green
-    config->colors[4] = (SDL_Color){255, 0, 255, 255};   // Magenta
-    config->num_colors = 5;
-
-    bool valid = true;
-    FILE* file = fopen("config.ini", "r");
-    if (!file) {
-        append_message(error_message, message_len, "config.ini missing; using defaults.");
+    if (!ticker->renderer) {
+        SDL_DestroyWindow(ticker->window);
+        ticker->window = NULL;
         return false;
     }
+    init_text_renderer(&ticker->text_renderer, ticker->renderer, fonts, config);
+    return true;
+}
 
-    char line[256];
-    while (fgets(line, sizeof(line), file)) {
-        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r' || line[0] == 0) {
-            continue;
+// Returns how many windows opened; every window shares the one font, fetch worker and headline store
+int open_ticker_windows(struct TickerWindow *windows, struct FontChain *fonts, Uint64 seed, const struct Config *config) {
+    TTF_Font *font = fonts->fonts[0];
+    SDL_Rect bounds[MAX_DISPLAYS];
+    int displays = SDL_GetNumVideoDisplays();
+    if (displays > MAX_DISPLAYS) displays = MAX_DISPLAYS;
+    if (config->display_layout == DISPLAY_PRIMARY && displays > 1) displays = 1;
+    for (int i = 0; i < displays; ++i) {
+        if (SDL_GetDisplayBounds(i, &bounds[i]) != 0) {
+            displays = i;
+            break;
         }
+    }
+    if (displays < 1) {
+        fprintf(stderr, "No usable display: %s\n", SDL_GetError());
+        return 0;
+    }
 
-        char *key = strtok(line, "=");
-        char *value = strtok(NULL, "\n");
-
-        if (key && value) {
-            trim_whitespace(key);
-            trim_whitespace(value);
-
-            if (strcmp(key, "api_key") == 0) strcpy(config->api_key, value);
-            else if (strcmp(key, "font_path") == 0) strcpy(config->font_path, value);
-            else if (strcmp(key, "font_size") == 0) config->font_size = atoi(value);
-            else if (strcmp(key, "country_code") == 0) strncpy(config->country_code, value, sizeof(config->country_code) - 1);
-            else if (strcmp(key, "refresh_interval_seconds") == 0) config->refresh_interval_seconds = atoi(value);
-            else if (strcmp(key, "line_padding") == 0) config->line_padding = atoi(value);
-            else if (strcmp(key, "scroll_speed_min") == 0) config->scroll_speed_min = (float)atof(value);
-            else if (strcmp(key, "scroll_speed_max") == 0) config->scroll_speed_max = (float)atof(value);
+    if (config->display_layout == DISPLAY_SPAN && displays > 1) {
+        // A single renderer means a single texture cache for every screen
+        SDL_Rect span = bounds[0];
+        for (int i = 1; i < displays; ++i) {
+            SDL_UnionRect(&span, &bounds[i], &span);
+        }
+        if (!open_ticker_window(&windows[0], span, SDL_WINDOW_BORDERLESS, true, fonts, config)) {
+            fprintf(stderr, "Unable to open spanning window: %s\n", SDL_GetError());
+            return 0;
+        }
+        for (int i = 0; i < displays; ++i) {
+            SDL_Rect area = { bounds[i].x - span.x, bounds[i].y - span.y, bounds[i].w, bounds[i].h };
+            if (!init_lane_pool(&windows[0].pools[i], font, area, seed, i, config)) break;
+            windows[0].pool_count++;
         }
+        return 1;
     }
-    fclose(file);
 
-    // Normalize country code to lowercase
-    for (size_t i = 0; config->country_code[i] != '\0'; ++i) {
+    int count = 0;
+    for (int i = 0; i < displays; ++i) {
+        SDL_Rect placement = { (int)SDL_WINDOWPOS_CENTERED_DISPLAY(i), (int)SDL_WINDOWPOS_CENTERED_DISPLAY(i), bounds[i].w, bounds[i].h };
+        // Only the first window waits for vsync; presenting the rest back to back keeps N screens from dividing the frame rate
+        if (!open_ticker_window(&windows[count], placement, SDL_WINDOW_FULLSCREEN_DESKTOP, count == 0, fonts, config)) {
+            fprintf(stderr, "Unable to open window on display %d: %s\n", i, SDL_GetError());
+            continue;
+        }
+        SDL_Rect area = { 0, 0, bounds[i].w, bounds[i].h };
+        if (init_lane_pool(&windows[count].pools[0], font, area, seed, i, config)) {
+            windows[count].pool_count = 1;
+        }
+        count++;
+    }
+    // One budget for the device, split evenly; each window's renderer holds its own textures
+    for (int i = 0; i < count; ++i) {
+        windows[i].text_renderer.budget.limit_bytes /= (size_t)count;
+        windows[i].text_renderer.budget.configured_bytes = windows[i].text_renderer.budget.limit_bytes;
+    }
+    return count;
+}
+
+void close_ticker_windows(struct TickerWindow *windows, int count) {
+    for (int i = 0; i < count; ++i) {
+        struct TickerWindow *ticker = &windows[i];
+        for (int p = 0; p < ticker->pool_count; ++p) {
+            destroy_lane_pool(&ticker->pools[p]);
+        }
+        destroy_glyph_atlas(&ticker->text_renderer.atlas);
+        destroy_texture_cache(&ticker->text_renderer.cache);
+        SDL_DestroyRenderer(ticker->renderer);
+        SDL_DestroyWindow(ticker->window);
+    }
+}
+
+static int count_lanes(const struct TickerWindow *windows, int count) {
+    int lanes = 0;
+    for (int w = 0; w < count; ++w) {
+        for (int p = 0; p < windows[w].pool_count; ++p) {
+            lanes += windows[w].pools[p].count;
+        }
+    }
+    return lanes;
+}
+
+static bool windows_moving(const struct TickerWindow *windows, int count) {
+    for (int w = 0; w < count; ++w) {
+        for (int p = 0; p < windows[w].pool_count; ++p) {
+            if (news_lines_moving(&windows[w].pools[p])) return true;
+        }
+    }
+    return false;
+}
+
+static float fastest_lane_speed(const struct TickerWindow *windows, int count) {
+    float fastest = 0.0f;
+    for (int w = 0; w < count; ++w) {
+        for (int p = 0; p < windows[w].pool_count; ++p) {
+            const struct LanePool *pool = &windows[w].pools[p];
+            for (int i = 0; i < pool->count; ++i) {
+                if (pool->speed[i] > fastest) fastest = pool->speed[i];
+            }
+        }
+    }
+    return fastest;
+}
+
+static bool lanes_showing(const struct TickerWindow *windows, int count) {
+    for (int w = 0; w < count; ++w) {
+        for (int p = 0; p < windows[w].pool_count; ++p) {
+            const struct LanePool *pool = &windows[w].pools[p];
+            for (int i = 0; i < pool->count; ++i) {
+                if (news_line_has_content(&pool->lines[i]) && pool->x[i] < pool->area.w) return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Relinks every pool before filling any, so a headline still scrolling on one display isn't dealt to another
+void attach_windows(struct TickerWindow *windows, int count, struct HeadlineStore *store, bool restart, const struct Config *config) {
+    for (int w = 0; w < count; ++w) {
+        for (int p = 0; p < windows[w].pool_count; ++p) {
+            attach_headline_store(&windows[w].pools[p], store, restart);
+        }
+    }
+    for (int w = 0; w < count; ++w) {
+        for (int p = 0; p < windows[w].pool_count; ++p) {
+            fill_empty_lanes(&windows[w].pools[p], store, config);
+            refill_lanes(&windows[w].pools[p], store, &windows[w].text_renderer, 0.0f, config);
+        }
+    }
+}
+
+// Hands lanes left empty by a small set to lines added since; they rasterize as they reach the edge
+static void fill_window_lanes(struct TickerWindow *windows, int count, struct HeadlineStore *store, const struct Config *config) {
+    for (int w = 0; w < count; ++w) {
+        for (int p = 0; p < windows[w].pool_count; ++p) {
+            fill_empty_lanes(&windows[w].pools[p], store, config);
+        }
+    }
+}
+
+// Only the counters are filled in; per-window caches are reported as one
+static void sum_texture_caches(const struct TickerWindow *windows, int count, struct TextureCache *totals) {
+    memset(totals, 0, sizeof(*totals));
+    for (int w = 0; w < count; ++w) {
+        const struct TextureCache *cache = &windows[w].text_renderer.cache;
+        totals->hits += cache->hits;
+        totals->misses += cache->misses;
+        totals->bytes += cache->bytes;
+    }
+}
+
+// Returns the bytes held now; the counters and limits in totals are summed across windows
+static size_t sum_texture_budgets(const struct TickerWindow *windows, int count, struct TextureBudget *totals) {
+    memset(totals, 0, sizeof(*totals));
+    size_t in_use = 0;
+    for (int w = 0; w < count; ++w) {
+        const struct TextureBudget *budget = &windows[w].text_renderer.budget;
+        in_use += texture_bytes_in_use(&windows[w].text_renderer);
+        totals->limit_bytes += budget->limit_bytes;
+        totals->line_bytes += budget->line_bytes;
+        totals->peak_bytes += budget->peak_bytes;
+        totals->evictions += budget->evictions;
+        totals->deferrals += budget->deferrals;
+        totals->failures += budget->failures;
+    }
+    return in_use;
+}
+
+// One fixed simulation step; a lane that leaves the screen waits for refill_lanes to respawn it.
+// Branch-free over plain arrays so the compiler can vectorize it; a wrapped lane drifting further off screen is harmless.
+void update_news_lines(struct LanePool *pool, float step_seconds) {
+    float *x = pool->x;
+    float *prev_x = pool->prev_x;
+    const float *speed = pool->speed;
+    const float *wrap_x = pool->wrap_x;
+    unsigned char *wrapped = pool->wrapped;
+    const int count = pool->count;
+    for (int i = 0; i < count; ++i) {
+        prev_x[i] = x[i];
+        x[i] -= speed[i] * step_seconds;
+        wrapped[i] |= (unsigned char)(x[i] < wrap_x[i]);
+    }
+}
+
+// Takes the whole steps owed by the accumulated time; alpha is how far the frame sits into the next one
+int drain_scroll_steps(double *accumulator, float *alpha) {
+    const double step = 1.0 / SCROLL_STEP_HZ;
+    int steps = 0;
+    while (*accumulator >= step && steps < MAX_SCROLL_STEPS) {
+        *accumulator -= step;
+        steps++;
+    }
+    if (*accumulator >= step) {
+        *accumulator = 0.0;
+    }
+    *alpha = (float)(*accumulator / step);
+    return steps;
+}
+
+void step_news_lines(struct LanePool *pool, int steps) {
+    for (int i = 0; i < steps; ++i) {
+        update_news_lines(pool, 1.0f / SCROLL_STEP_HZ);
+    }
+}
+
+static bool news_lines_moving(const struct LanePool *pool) {
+    for (int i = 0; i < pool->count; ++i) {
+        if (pool->speed[i] != 0.0f) return true;
+    }
+    return false;
+}
+
+// How long the loop may block for input before a HUD refresh or telemetry record is due
+Uint32 idle_wait_ms(const struct Hud *hud, const struct TelemetryLog *telemetry, Uint32 next_telemetry) {
+    Uint32 now = SDL_GetTicks();
+    Uint32 wait = IDLE_POLL_MS;
+    if (hud->visible) {
+        Uint32 until = SDL_TICKS_PASSED(now, hud->next_update) ? 0 : hud->next_update - now;
+        if (until < wait) wait = until;
+    }
+    if (telemetry->file) {
+        Uint32 until = SDL_TICKS_PASSED(now, next_telemetry) ? 0 : next_telemetry - now;
+        if (until < wait) wait = until;
+    }
+    return wait;
+}
+
+void render_text(struct TextRenderer *text_renderer, struct NewsLine *line) {
+    if (line->texture) {
+        SDL_DestroyTexture(line->texture);
+    }
+    SDL_Surface* surface = render_shaped_text(text_renderer->fonts, line->text, line->color);
+    if (surface) {
+        line->texture = SDL_CreateTextureFromSurface(text_renderer->renderer, surface);
+        line->texture_width = surface->w;
+        line->texture_height = surface->h;
+        SDL_FreeSurface(surface);
+    } else {
+        line->texture = NULL;
+        line->texture_width = 0;
+        line->texture_height = 0;
+    }
+}
+
+// Texture mode's single entry to rasterization: lines the snapshot holds skip FreeType entirely
+static void render_line_texture(struct TextRenderer *text_renderer, struct NewsLine *line) {
+    struct LineSnapshot *snapshot = text_renderer->snapshot;
+    if (!snapshot) {
+        render_text(text_renderer, line);
+        return;
+    }
+    if (line->texture) {
+        SDL_DestroyTexture(line->texture);
+        line->texture = NULL;
+    }
+    Uint64 key = texture_cache_key(line->text, line->color, text_renderer->font_size);
+    if (texture_from_snapshot(text_renderer, key, line)) return;
+
+    SDL_Surface *surface = render_shaped_text(text_renderer->fonts, line->text, line->color);
+    capture_line_snapshot(snapshot, key, line, surface);
+    if (!surface) {
+        line->texture_width = 0;
+        line->texture_height = 0;
+        return;
+    }
+    line->texture = SDL_CreateTextureFromSurface(text_renderer->renderer, surface);
+    line->texture_width = surface->w;
+    line->texture_height = surface->h;
+    SDL_FreeSurface(surface);
+}
+
+// Identifies the rasterization a snapshot came from; any other font file, fallback list, size or metrics invalidates it
+static Uint64 snapshot_font_id(const char *font_file, const char *fallback_fonts, TTF_Font *font, int font_size) {
+    const int metrics[] = { font_size, TTF_FontHeight(font) };
+    Uint64 hash = hash_bytes(font_file, strlen(font_file), FNV_OFFSET_BASIS);
+    hash = hash_bytes(fallback_fonts, strlen(fallback_fonts), hash);
+    return hash_bytes(metrics, sizeof(metrics), hash);
+}
+
+void open_line_snapshot(struct LineSnapshot *snapshot, const char *font_file, TTF_Font *font, const struct Config *config) {
+    memset(snapshot, 0, sizeof(*snapshot));
+    if (config->text_render_mode == TEXT_RENDER_ATLAS) return;
+    snprintf(snapshot->path, sizeof(snapshot->path), "%s", config->snapshot_path);
+    snapshot->font_id = snapshot_font_id(font_file, config->fallback_fonts, font, config->font_size);
+    if (snapshot_map(&snapshot->file, snapshot->path, snapshot->font_id)) {
+        fprintf(stdout, "Mapped %u prerasterized lines from %s.\n", (unsigned)snapshot->file.count, snapshot->path);
+    }
+}
+
+// Writes whatever part of the current set was drawn; a short run still leaves the next one a head start
+void close_line_snapshot(struct LineSnapshot *snapshot) {
+    if (snapshot->captured > 0) {
+        int kept = 0;
+        for (int i = 0; i < snapshot->capture_count; ++i) {
+            if (snapshot->captures[i].coverage) snapshot->captures[kept++] = snapshot->captures[i];
+            else free(snapshot->captures[i].text);
+        }
+        snapshot->capture_count = kept;
+        snapshot->captured = kept;
+        flush_line_snapshot(snapshot);
+    }
+    clear_snapshot_captures(snapshot);
+    snapshot_unmap(&snapshot->file);
+}
+
+static void clear_snapshot_captures(struct LineSnapshot *snapshot) {
+    for (int i = 0; i < snapshot->capture_count; ++i) {
+        free(snapshot->captures[i].text);
+        free(snapshot->captures[i].coverage);
+    }
+    free(snapshot->captures);
+    snapshot->captures = NULL;
+    snapshot->capture_count = 0;
+    snapshot->captured = 0;
+}
+
+// What the lanes show once a set is attached is what a restart shows first, so that is what gets recorded
+void plan_line_snapshot(struct LineSnapshot *snapshot, const struct TickerWindow *windows, int window_count, int font_size) {
+    clear_snapshot_captures(snapshot);
+    int lanes = count_lanes(windows, window_count);
+    if (!snapshot->path[0] || lanes <= 0) return;
+    snapshot->captures = calloc((size_t)lanes, sizeof(*snapshot->captures));
+    if (!snapshot->captures) return;
+
+    bool changed = false;
+    for (int w = 0; w < window_count; ++w) {
+        for (int p = 0; p < windows[w].pool_count; ++p) {
+            const struct LanePool *pool = &windows[w].pools[p];
+            for (int i = 0; i < pool->count; ++i) {
+                const struct NewsLine *line = &pool->lines[i];
+                if (!line->text) continue;
+                Uint64 key = texture_cache_key(line->text, line->color, font_size);
+                bool planned = false;
+                for (int c = 0; c < snapshot->capture_count && !planned; ++c) {
+                    planned = snapshot->captures[c].key == key && strcmp(snapshot->captures[c].text, line->text) == 0;
+                }
+                if (planned) continue;
+                struct SnapshotCapture *capture = &snapshot->captures[snapshot->capture_count];
+                size_t len = strlen(line->text);
+                capture->key = key;
+                capture->text = malloc(len + 1);
+                if (!capture->text) continue;
+                memcpy(capture->text, line->text, len + 1);
+                snapshot->capture_count++;
+
+                // Lines already in the file are carried over now; the mapping is replaced when the new file is written
+                struct SnapshotLine stored;
+                if (!snapshot_lookup(&snapshot->file, capture->key, capture->text, &stored)) {
+                    changed = true;
+                    continue;
+                }
+                size_t bytes = (size_t)stored.width * stored.height;
+                capture->coverage = malloc(bytes);
+                if (!capture->coverage) continue;
+                memcpy(capture->coverage, stored.coverage, bytes);
+                capture->width = (int)stored.width;
+                capture->height = (int)stored.height;
+                snapshot->captured++;
+            }
+        }
+    }
+    if (!changed && (int)snapshot->file.count == snapshot->capture_count) clear_snapshot_captures(snapshot);
+}
+
+// Lanes kept from the last set hold on to their texture and are never rasterized again, so a planned line
+// one of them shows is rendered once more for the snapshot. A planned line no lane shows any more is skipped.
+void settle_line_snapshot(struct LineSnapshot *snapshot, struct TickerWindow *windows, int window_count) {
+    if (snapshot->captured >= snapshot->capture_count) return;
+    for (int c = 0; c < snapshot->capture_count; ++c) {
+        struct SnapshotCapture *capture = &snapshot->captures[c];
+        if (capture->coverage || capture->skipped) continue;
+        const struct NewsLine *shown = NULL;
+        struct TextRenderer *text_renderer = NULL;
+        for (int w = 0; w < window_count && !shown; ++w) {
+            for (int p = 0; p < windows[w].pool_count && !shown; ++p) {
+                const struct LanePool *pool = &windows[w].pools[p];
+                for (int i = 0; i < pool->count; ++i) {
+                    const struct NewsLine *line = &pool->lines[i];
+                    if (!line->text || strcmp(line->text, capture->text) != 0) continue;
+                    if (texture_cache_key(line->text, line->color, windows[w].text_renderer.font_size) != capture->key) continue;
+                    shown = line;
+                    text_renderer = &windows[w].text_renderer;
+                    break;
+                }
+            }
+        }
+        if (!shown) {
+            capture->skipped = true;
+            snapshot->captured++;
+            continue;
+        }
+        if (!news_line_has_content(shown)) continue; // Captured when it is rasterized
+        SDL_Surface *surface = render_shaped_text(text_renderer->fonts, shown->text, shown->color);
+        capture_line_snapshot(snapshot, capture->key, shown, surface);
+        if (surface) SDL_FreeSurface(surface);
+    }
+}
+
+// Called between frames; writes the snapshot once every planned line has been rasterized
+void flush_line_snapshot(struct LineSnapshot *snapshot) {
+    if (snapshot->capture_count == 0 || snapshot->captured < snapshot->capture_count) return;
+    struct SnapshotLine *lines = malloc(sizeof(*lines) * (size_t)snapshot->capture_count);
+    if (!lines) return;
+    int count = 0;
+    for (int i = 0; i < snapshot->capture_count; ++i) {
+        const struct SnapshotCapture *capture = &snapshot->captures[i];
+        if (!capture->coverage) continue;
+        lines[count++] = (struct SnapshotLine){ capture->key, capture->text, (uint32_t)strlen(capture->text), (uint32_t)capture->width, (uint32_t)capture->height, capture->coverage };
+    }
+    snapshot_unmap(&snapshot->file);
+    if (!snapshot_save(snapshot->path, snapshot->font_id, lines, count)) {
+        fprintf(stderr, "Unable to write line snapshot %s.\n", snapshot->path);
+    }
+    snapshot_map(&snapshot->file, snapshot->path, snapshot->font_id);
+    free(lines);
+    clear_snapshot_captures(snapshot);
+}
+
+static bool texture_from_snapshot(struct TextRenderer *text_renderer, Uint64 key, struct NewsLine *line) {
+    struct LineSnapshot *snapshot = text_renderer->snapshot;
+    struct SnapshotLine stored;
+    if (!snapshot_lookup(&snapshot->file, key, line->text, &stored)) return false;
+    SDL_Texture *texture = texture_from_coverage(text_renderer->renderer, stored.coverage, (int)stored.width, (int)stored.width, (int)stored.height, line->color);
+    if (!texture) return false;
+
+    line->texture = texture;
+    line->texture_width = (int)stored.width;
+    line->texture_height = (int)stored.height;
+    snapshot->hits++;
+    return true;
+}
+
+// Keeps the alpha channel of a freshly rendered line if the next snapshot is waiting for it.
+// A NULL surface is a line that failed to render; it is skipped so the rest can still be written.
+static void capture_line_snapshot(struct LineSnapshot *snapshot, Uint64 key, const struct NewsLine *line, SDL_Surface *surface) {
+    struct SnapshotCapture *capture = wanted_capture(snapshot, key, line->text);
+    if (!capture) return;
+    capture->coverage = surface ? surface_coverage(surface) : NULL;
+    if (capture->coverage) {
+        capture->width = surface->w;
+        capture->height = surface->h;
+    } else {
+        capture->skipped = true;
+    }
+    snapshot->captured++;
+}
+
+static struct SnapshotCapture *wanted_capture(struct LineSnapshot *snapshot, Uint64 key, const char *text) {
+    for (int i = 0; i < snapshot->capture_count; ++i) {
+        struct SnapshotCapture *capture = &snapshot->captures[i];
+        if (!capture->coverage && !capture->skipped && capture->key == key && strcmp(capture->text, text) == 0) return capture;
+    }
+    return NULL;
+}
+
+// The alpha channel of a blended surface, rows packed; NULL for a format without one
+static Uint8 *surface_coverage(SDL_Surface *surface) {
+    if (surface->format->BytesPerPixel != 4 || surface->format->Amask == 0) return NULL;
+    Uint8 *coverage = malloc((size_t)surface->w * (size_t)surface->h);
+    if (!coverage) return NULL;
+    if (SDL_MUSTLOCK(surface) && SDL_LockSurface(surface) != 0) {
+        free(coverage);
+        return NULL;
+    }
+    const Uint32 mask = surface->format->Amask;
+    const Uint8 shift = surface->format->Ashift;
+    for (int y = 0; y < surface->h; ++y) {
+        const Uint32 *row = (const Uint32 *)((const Uint8 *)surface->pixels + (size_t)y * surface->pitch);
+        Uint8 *out = coverage + (size_t)y * surface->w;
+        for (int x = 0; x < surface->w; ++x) {
+            out[x] = (Uint8)((row[x] & mask) >> shift);
+        }
+    }
+    if (SDL_MUSTLOCK(surface)) SDL_UnlockSurface(surface);
+    return coverage;
+}
+
+// Blended text is one flat color, so coverage plus the line color rebuilds the rendered pixels exactly
+static SDL_Texture *texture_from_coverage(SDL_Renderer *renderer, const Uint8 *coverage, int pitch, int width, int height, SDL_Color color) {
+    Uint32 *argb = malloc((size_t)width * (size_t)height * sizeof(Uint32));
+    if (!argb) return NULL;
+    const Uint32 rgb = ((Uint32)color.r << 16) | ((Uint32)color.g << 8) | color.b;
+    for (int y = 0; y < height; ++y) {
+        const Uint8 *in = coverage + (size_t)y * (size_t)pitch;
+        Uint32 *out = argb + (size_t)y * (size_t)width;
+        for (int x = 0; x < width; ++x) {
+            out[x] = ((Uint32)in[x] << 24) | rgb;
+        }
+    }
+    SDL_Texture *texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, width, height);
+    if (texture && SDL_UpdateTexture(texture, NULL, argb, width * (int)sizeof(Uint32)) != 0) {
+        SDL_DestroyTexture(texture);
+        texture = NULL;
+    }
+    free(argb);
+    if (texture) SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return texture;
+}
+
+static bool line_exceeds_texture(struct TextRenderer *text_renderer, const struct NewsLine *line) {
+    if (text_renderer->max_texture_width <= 0) return false;
+    const struct ShapedLine *shaped = shape_line(text_renderer->fonts, line->text);
+    return shaped && shaped->width > text_renderer->max_texture_width;
+}
+
+// Rasterizes once into system memory; stream_line_tiles uploads the pieces as they come into view
+static void build_line_tiles(struct TextRenderer *text_renderer, struct NewsLine *line) {
+    struct LineSnapshot *snapshot = text_renderer->snapshot;
+    Uint64 key = texture_cache_key(line->text, line->color, text_renderer->font_size);
+    Uint8 *coverage = NULL;
+    int width = 0;
+    int height = 0;
+    struct SnapshotLine stored;
+    if (snapshot && snapshot_lookup(&snapshot->file, key, line->text, &stored)) {
+        coverage = malloc((size_t)stored.width * stored.height);
+        if (coverage) {
+            memcpy(coverage, stored.coverage, (size_t)stored.width * stored.height);
+            width = (int)stored.width;
+            height = (int)stored.height;
+            snapshot->hits++;
+        }
+    }
+    if (!coverage) {
+        SDL_Surface *surface = render_shaped_text(text_renderer->fonts, line->text, line->color);
+        if (snapshot) capture_line_snapshot(snapshot, key, line, surface);
+        if (!surface) return;
+        coverage = surface_coverage(surface);
+        width = surface->w;
+        height = surface->h;
+        SDL_FreeSurface(surface);
+        if (!coverage) return;
+    }
+
+    struct LineTiles *tiles = calloc(1, sizeof(*tiles));
+    int count = (width + text_renderer->tile_width - 1) / text_renderer->tile_width;
+    SDL_Texture **textures = tiles ? calloc((size_t)(count > 0 ? count : 1), sizeof(*textures)) : NULL;
+    if (!textures) {
+        free(tiles);
+        free(coverage);
+        return;
+    }
+    tiles->coverage = coverage;
+    tiles->tile_width = text_renderer->tile_width;
+    tiles->count = count;
+    tiles->textures = textures;
+    line->tiles = tiles;
+    line->budget = &text_renderer->budget;
+    line->texture_width = width;
+    line->texture_height = height;
+}
+
+// Keeps resident the tiles drawable before the next refill, plus the one about to scroll in from the right
+static void stream_line_tiles(struct TextRenderer *text_renderer, struct LanePool *pool, int lane, float raster_edge) {
+    struct NewsLine *line = &pool->lines[lane];
+    struct LineTiles *tiles = line->tiles;
+    // Frames interpolate between prev_x and x, and lanes only move left, so prev_x >= x
+    const float first = -pool->prev_x[lane];
+    const float last = (float)pool->area.w - pool->x[lane] + (float)tiles->tile_width;
+    for (int t = 0; t < tiles->count; ++t) {
+        int left = t * tiles->tile_width;
+        int width = line->texture_width - left < tiles->tile_width ? line->texture_width - left : tiles->tile_width;
+        size_t bytes = (size_t)width * (size_t)line->texture_height * 4;
+        bool wanted = (float)(left + width) >= first && (float)left <= last;
+        if (!wanted && tiles->textures[t]) {
+            SDL_DestroyTexture(tiles->textures[t]);
+            tiles->textures[t] = NULL;
+            line->budget->line_bytes -= bytes;
+        } else if (wanted && !tiles->textures[t]) {
+            // The tile is about to be seen, so it is uploaded even if nothing else can make room.
+            // A lane still off screen is itself an eviction candidate, so it doesn't ask.
+            if (pool->x[lane] <= (float)pool->area.w) make_texture_room(text_renderer, pool, bytes, raster_edge);
+            tiles->textures[t] = texture_from_coverage(text_renderer->renderer, tiles->coverage + left, line->texture_width, width, line->texture_height, line->color);
+            if (!tiles->textures[t]) {
+                text_renderer->budget.failures++; // Retried on the next refill
+                continue;
+            }
+            line->budget->line_bytes += bytes;
+            size_t in_use = texture_bytes_in_use(text_renderer);
+            if (in_use > text_renderer->budget.peak_bytes) text_renderer->budget.peak_bytes = in_use;
+        }
+    }
+}
+
+static void release_line_tiles(struct NewsLine *line) {
+    struct LineTiles *tiles = line->tiles;
+    for (int t = 0; t < tiles->count; ++t) {
+        if (!tiles->textures[t]) continue;
+        int left = t * tiles->tile_width;
+        int width = line->texture_width - left < tiles->tile_width ? line->texture_width - left : tiles->tile_width;
+        line->budget->line_bytes -= (size_t)width * (size_t)line->texture_height * 4;
+        SDL_DestroyTexture(tiles->textures[t]);
+    }
+    free(tiles->textures);
+    free(tiles->coverage);
+    free(tiles);
+    line->tiles = NULL;
+}
+
+static bool font_has_glyph(TTF_Font *font, uint32_t codepoint) {
+#ifdef TTF_HAS_UCS4
+    return TTF_GlyphIsProvided32(font, codepoint) != 0;
+#else
+    return codepoint <= 0xFFFF && TTF_GlyphIsProvided(font, (Uint16)codepoint) != 0;
+#endif
+}
+
+static bool font_provides_glyph(uint32_t codepoint, void *ctx) {
+    return font_for_codepoint((struct FontChain *)ctx, codepoint) >= 0;
+}
+
+// Blanks characters no font in the chain can draw; returns false when nothing visible is left.
+// Runs on the main thread because the fetch worker never touches the fonts.
+static bool drop_missing_glyphs(struct FontChain *fonts, char *text) {
+    const unsigned char *p = (const unsigned char *)text;
+    while (*p && *p < 0x80) p++;
+    if (*p) {
+        sanitize_filter_glyphs(text, font_provides_glyph, fonts);
+    }
+    return text[strspn(text, " ")] != '\0';
+}
+
+// The primary font as open_font_with_fallback finds it, then every fallback_fonts entry that opens
+bool open_font_chain(struct FontChain *fonts, const struct Config *config, const char **opened_path) {
+    memset(fonts, 0, sizeof(*fonts));
+    fonts->fonts[0] = open_font_with_fallback(config->font_path, config->font_size, opened_path);
+    if (!fonts->fonts[0]) return false;
+    fonts->count = 1;
+
+    char list[sizeof(config->fallback_fonts)];
+    memcpy(list, config->fallback_fonts, sizeof(list));
+    for (char *path = strtok(list, ","); path && fonts->count < MAX_FONT_CHAIN; path = strtok(NULL, ",")) {
+        trim_whitespace(path);
+        if (!path[0] || strcmp(path, "none") == 0) continue;
+        // The defaults name fonts from several distributions, so a missing one is expected and not reported
+        TTF_Font *font = TTF_OpenFont(path, config->font_size);
+        if (font) fonts->fonts[fonts->count++] = font;
+    }
+    for (int i = 0; i < fonts->count; ++i) {
+        fonts->ascent[i] = TTF_FontAscent(fonts->fonts[i]);
+    }
+    return true;
+}
+
+void close_font_chain(struct FontChain *fonts) {
+    for (int i = 0; i < fonts->count; ++i) {
+        TTF_CloseFont(fonts->fonts[i]);
+    }
+    for (int i = 0; i < fonts->shaped_count; ++i) {
+        free(fonts->shaped[i]->text);
+        free(fonts->shaped[i]);
+    }
+    free(fonts->shaped);
+    memset(fonts, 0, sizeof(*fonts));
+}
+
+// First font in the chain with the glyph, or -1; memoized since a headline asks once per character
+static int font_for_codepoint(struct FontChain *fonts, uint32_t codepoint) {
+    struct FontChoice *choice = &fonts->resolved[(codepoint * 2654435761u) & (FONT_RESOLVE_SLOTS - 1)];
+    if (choice->known && choice->codepoint == codepoint) return choice->font;
+    int font = -1;
+    for (int i = 0; i < fonts->count && font < 0; ++i) {
+        if (font_has_glyph(fonts->fonts[i], codepoint)) font = i;
+    }
+    choice->codepoint = codepoint;
+    choice->font = font;
+    choice->known = true;
+    return font;
+}
+
+// Splits text into runs of one font and measures them. Spaces and ASCII punctuation stay in the run
+// around them when its font has them, so a CJK headline isn't cut into a run per word.
+static struct ShapedLine *itemize_line(struct FontChain *fonts, const char *text, Uint64 key) {
+    size_t len = strlen(text);
+    struct ShapedLine *shaped = malloc(sizeof(*shaped) + sizeof(struct ShapedRun) * (len > 0 ? len : 1));
+    char *copy = malloc(len + 1);
+    char *run_text = malloc(len + 1);
+    if (!shaped || !copy || !run_text) {
+        free(shaped);
+        free(copy);
+        free(run_text);
+        return NULL;
+    }
+    memcpy(copy, text, len + 1);
+    shaped->key = key;
+    shaped->text = copy;
+    shaped->run_count = 0;
+    shaped->height = TTF_FontHeight(fonts->fonts[0]);
+
+    struct ShapedRun *run = NULL;
+    for (size_t i = 0; i < len;) {
+        uint32_t c = (unsigned char)text[i];
+        size_t step = c < 0x80 ? 1 : utf8_decode(text + i, &c);
+        if (step == 0) step = 1; // Sanitized text is well formed; don't stall on anything that isn't
+        int font = font_for_codepoint(fonts, c);
+        bool neutral = c < 0x80 && !isalnum((int)c);
+        if (run && (font < 0 || font == run->font || (neutral && font_has_glyph(fonts->fonts[run->font], c)))) {
+            run->length += (int)step;
+        } else {
+            run = &shaped->runs[shaped->run_count++];
+            run->font = font < 0 ? 0 : font;
+            run->start = (int)i;
+            run->length = (int)step;
+        }
+        i += step;
+    }
+
+    int pen = 0;
+    for (int r = 0; r < shaped->run_count; ++r) {
+        struct ShapedRun *item = &shaped->runs[r];
+        memcpy(run_text, text + item->start, (size_t)item->length);
+        run_text[item->length] = '\0';
+        int width = 0;
+        item->x = pen;
+        if (TTF_SizeUTF8(fonts->fonts[item->font], run_text, &width, NULL) == 0) pen += width;
+    }
+    shaped->width = pen;
+    free(run_text);
+    // Sized for a run per byte while itemizing; most lines end up with one
+    struct ShapedLine *trimmed = realloc(shaped, sizeof(*shaped) + sizeof(struct ShapedRun) * (size_t)(shaped->run_count > 0 ? shaped->run_count : 1));
+    return trimmed ? trimmed : shaped;
+}
+
+// Itemizes each distinct headline once; every later pass, window and render mode reuses the runs
+static const struct ShapedLine *shape_line(struct FontChain *fonts, const char *text) {
+    Uint64 key = hash_bytes(text, strlen(text), FNV_OFFSET_BASIS);
+    for (int i = 0; i < fonts->shaped_count; ++i) {
+        struct ShapedLine *shaped = fonts->shaped[i];
+        if (shaped->key == key && strcmp(shaped->text, text) == 0) {
+            shaped->last_used = ++fonts->clock;
+            fonts->shape_hits++;
+            return shaped;
+        }
+    }
+    struct ShapedLine *shaped = itemize_line(fonts, text, key);
+    if (!shaped) return NULL;
+    fonts->shape_misses++;
+    shaped->last_used = ++fonts->clock;
+
+    if (!fonts->shaped) {
+        fonts->shaped = malloc(sizeof(*fonts->shaped) * SHAPE_CACHE_MAX);
+        if (!fonts->shaped) {
+            // Uncached runs would leak; callers only need the line for as long as it takes to draw
+            free(shaped->text);
+            free(shaped);
+            return NULL;
+        }
+    }
+    if (fonts->shaped_count == SHAPE_CACHE_MAX) {
+        int oldest = 0;
+        for (int i = 1; i < fonts->shaped_count; ++i) {
+            if (fonts->shaped[i]->last_used < fonts->shaped[oldest]->last_used) oldest = i;
+        }
+        free(fonts->shaped[oldest]->text);
+        free(fonts->shaped[oldest]);
+        fonts->shaped[oldest] = fonts->shaped[--fonts->shaped_count];
+    }
+    fonts->shaped[fonts->shaped_count++] = shaped;
+    return shaped;
+}
+
+// Headlines in the primary font alone go straight to SDL_ttf. Mixed lines render each run and merge the
+// coverage on the primary baseline, so the result is the same flat-colored blended surface either way.
+static SDL_Surface *render_shaped_text(struct FontChain *fonts, const char *text, SDL_Color color) {
+    const struct ShapedLine *shaped = shape_line(fonts, text);
+    if (!shaped) return NULL;
+    if (shaped->run_count <= 1 && (shaped->run_count == 0 || shaped->runs[0].font == 0)) {
+        return TTF_RenderUTF8_Blended(fonts->fonts[0], text, color);
+    }
+    if (shaped->width <= 0 || shaped->height <= 0) return NULL;
+
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, shaped->width, shaped->height, 32, SDL_PIXELFORMAT_ARGB8888);
+    Uint8 *coverage = calloc((size_t)shaped->width * (size_t)shaped->height, 1);
+    char *run_text = malloc(strlen(text) + 1);
+    if (!surface || !coverage || !run_text) {
+        if (surface) SDL_FreeSurface(surface);
+        free(coverage);
+        free(run_text);
+        return NULL;
+    }
+    for (int r = 0; r < shaped->run_count; ++r) {
+        const struct ShapedRun *run = &shaped->runs[r];
+        memcpy(run_text, text + run->start, (size_t)run->length);
+        run_text[run->length] = '\0';
+        SDL_Surface *piece = TTF_RenderUTF8_Blended(fonts->fonts[run->font], run_text, (SDL_Color){255, 255, 255, 255});
+        Uint8 *alpha = piece ? surface_coverage(piece) : NULL;
+        if (alpha) {
+            const int shift = fonts->ascent[0] - fonts->ascent[run->font];
+            for (int y = 0; y < piece->h; ++y) {
+                int row = y + shift;
+                if (row < 0 || row >= shaped->height) continue;
+                const Uint8 *in = alpha + (size_t)y * piece->w;
+                Uint8 *out = coverage + (size_t)row * shaped->width;
+                // Max keeps overhanging glyph edges from neighbouring runs instead of overwriting them
+                for (int x = 0; x < piece->w && run->x + x < shaped->width; ++x) {
+                    if (in[x] > out[run->x + x]) out[run->x + x] = in[x];
+                }
+            }
+        }
+        free(alpha);
+        if (piece) SDL_FreeSurface(piece);
+    }
+    free(run_text);
+
+    const Uint32 rgb = ((Uint32)color.r << 16) | ((Uint32)color.g << 8) | color.b;
+    for (int y = 0; y < shaped->height; ++y) {
+        Uint32 *out = (Uint32 *)((Uint8 *)surface->pixels + (size_t)y * surface->pitch);
+        const Uint8 *in = coverage + (size_t)y * shaped->width;
+        for (int x = 0; x < shaped->width; ++x) {
+            out[x] = ((Uint32)in[x] << 24) | rgb;
+        }
+    }
+    free(coverage);
+    return surface;
+}
+
+bool init_glyph_atlas(struct GlyphAtlas *atlas, SDL_Renderer *renderer, TTF_Font *font) {
+    if (!atlas || !renderer || !font) return false;
+
+    memset(atlas, 0, sizeof(*atlas));
+    int size = GLYPH_ATLAS_SIZE;
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(renderer, &info) == 0) {
+        if (info.max_texture_width > 0 && info.max_texture_width < size) size = info.max_texture_width;
+        if (info.max_texture_height > 0 && info.max_texture_height < size) size = info.max_texture_height;
+    }
+
+    atlas->texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, size, size);
+    if (!atlas->texture) return false;
+    SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+
+    // Static textures start undefined; clear once so filtering at glyph edges samples transparency
+    Uint32 *blank = calloc((size_t)size * (size_t)size, sizeof(Uint32));
+    if (blank) {
+        SDL_UpdateTexture(atlas->texture, NULL, blank, size * (int)sizeof(Uint32));
+        free(blank);
+    }
+
+    // Twice the glyphs that fit at half the line height wide keeps the table at most half full
+    int cell_h = TTF_FontHeight(font) + GLYPH_ATLAS_PADDING;
+    int cell_w = TTF_FontHeight(font) / 2 + GLYPH_ATLAS_PADDING;
+    size_t capacity = (size_t)(size / (cell_w > 0 ? cell_w : 1)) * (size_t)(size / (cell_h > 0 ? cell_h : 1));
+    size_t slots = 64;
+    while (slots < capacity * 2) slots *= 2;
+    atlas->glyphs = calloc(slots, sizeof(struct AtlasGlyph));
+    atlas->slot_mask = (Uint32)(slots - 1);
+
+    atlas->vertices = malloc(sizeof(SDL_Vertex) * GLYPH_BATCH_QUADS * 4);
+    atlas->indices = malloc(sizeof(int) * GLYPH_BATCH_QUADS * 6);
+    if (!atlas->glyphs || !atlas->vertices || !atlas->indices) {
+        destroy_glyph_atlas(atlas);
+        return false;
+    }
+    for (int q = 0; q < GLYPH_BATCH_QUADS; ++q) {
+        int *idx = &atlas->indices[q * 6];
+        int base = q * 4;
+        idx[0] = base;
+        idx[1] = base + 1;
+        idx[2] = base + 2;
+        idx[3] = base + 2;
+        idx[4] = base + 1;
+        idx[5] = base + 3;
+    }
+
+    atlas->width = size;
+    atlas->height = size;
+    atlas->pen_x = GLYPH_ATLAS_PADDING;
+    atlas->pen_y = GLYPH_ATLAS_PADDING;
+    atlas->line_height = TTF_FontHeight(font);
+    return true;
+}
+
+void destroy_glyph_atlas(struct GlyphAtlas *atlas) {
+    if (!atlas) return;
+    if (atlas->texture) {
+        SDL_DestroyTexture(atlas->texture);
+    }
+    free(atlas->glyphs);
+    free(atlas->vertices);
+    free(atlas->indices);
+    memset(atlas, 0, sizeof(*atlas));
+}
+
+// Returns the glyph entry, rasterizing it into the atlas on first use; NULL once the table is full
+static const struct AtlasGlyph *atlas_glyph(struct GlyphAtlas *atlas, struct FontChain *fonts, int font_index, Uint32 codepoint) {
+    TTF_Font *font = fonts->fonts[font_index];
+    Uint32 slot = ((codepoint ^ ((Uint32)font_index << 24)) * 2654435761u) & atlas->slot_mask;
+    for (Uint32 probe = 0; probe <= atlas->slot_mask; ++probe) {
+        struct AtlasGlyph *glyph = &atlas->glyphs[slot];
+        if (glyph->present && glyph->codepoint == codepoint && glyph->font == font_index) {
+            return glyph;
+        }
+        if (!glyph->present) {
+            glyph->present = true;
+            glyph->codepoint = codepoint;
+            glyph->font = font_index;
+            glyph->resident = false;
+            glyph->spilled = false;
+            // Glyph surfaces are a full line tall with the baseline at the font's ascent; line them up on the primary's
+            glyph->y_offset = fonts->ascent[0] - fonts->ascent[font_index];
+
+            int minx = 0, maxx = 0, miny = 0, maxy = 0, advance = 0;
+#ifdef TTF_HAS_UCS4
+            int metrics = TTF_GlyphMetrics32(font, codepoint, &minx, &maxx, &miny, &maxy, &advance);
+#else
+            int metrics = codepoint <= 0xFFFF ? TTF_GlyphMetrics(font, (Uint16)codepoint, &minx, &maxx, &miny, &maxy, &advance) : -1;
+#endif
+            if (metrics != 0) {
+                return glyph;
+            }
+            glyph->advance = advance;
+            glyph->x_offset = minx < 0 ? minx : 0;
+
+#ifdef TTF_HAS_UCS4
+            SDL_Surface *surface = TTF_RenderGlyph32_Blended(font, codepoint, (SDL_Color){255, 255, 255, 255});
+#else
+            SDL_Surface *surface = TTF_RenderGlyph_Blended(font, (Uint16)codepoint, (SDL_Color){255, 255, 255, 255});
+#endif
+            if (!surface) {
+                return glyph;
+            }
+            if (surface->format->format != SDL_PIXELFORMAT_ARGB8888) {
+                SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+                SDL_FreeSurface(surface);
+                surface = converted;
+                if (!surface) return glyph;
+            }
+
+            if (atlas->pen_x + surface->w + GLYPH_ATLAS_PADDING > atlas->width) {
+                atlas->pen_x = GLYPH_ATLAS_PADDING;
+                atlas->pen_y += atlas->row_height + GLYPH_ATLAS_PADDING;
+                atlas->row_height = 0;
+            }
+            if (atlas->pen_y + surface->h + GLYPH_ATLAS_PADDING <= atlas->height && surface->w > 0 && surface->h > 0) {
+                glyph->src = (SDL_Rect){ atlas->pen_x, atlas->pen_y, surface->w, surface->h };
+                SDL_UpdateTexture(atlas->texture, &glyph->src, surface->pixels, surface->pitch);
+                glyph->resident = true;
+                atlas->pen_x += surface->w + GLYPH_ATLAS_PADDING;
+                if (surface->h > atlas->row_height) atlas->row_height = surface->h;
+            } else if (surface->w > 0 && surface->h > 0) {
+                glyph->spilled = true;
+                atlas->full = true;
+            }
+            SDL_FreeSurface(surface);
+            return glyph;
+        }
+        slot = (slot + 1) & atlas->slot_mask;
+    }
+    atlas->full = true;
+    return NULL;
+}
+
+bool layout_atlas_text(struct TextRenderer *text_renderer, struct NewsLine *line) {
+    struct GlyphAtlas *atlas = &text_renderer->atlas;
+    size_t len = strlen(line->text);
+    line->quads = malloc(sizeof(struct GlyphQuad) * (len > 0 ? len : 1));
+    line->quad_count = 0;
+    line->texture_width = 0;
+    line->texture_height = 0;
+    const struct ShapedLine *shaped = shape_line(text_renderer->fonts, line->text);
+    if (!line->quads || !shaped) {
+        free(line->quads);
+        line->quads = NULL;
+        return false;
+    }
+
+    float inv_w = 1.0f / (float)atlas->width;
+    float inv_h = 1.0f / (float)atlas->height;
+    int pen = 0;
+    for (int r = 0; r < shaped->run_count; ++r) {
+        const struct ShapedRun *run = &shaped->runs[r];
+        TTF_Font *font = text_renderer->fonts->fonts[run->font];
+        const size_t end = (size_t)(run->start + run->length);
+        Uint32 previous = 0; // Kerning pairs only exist within one font
+        for (size_t i = (size_t)run->start; i < end;) {
+            uint32_t c = 0;
+            size_t step = utf8_decode(line->text + i, &c);
+            if (step == 0) {
+                ++i; // Sanitized text is well formed; skip anything that isn't rather than stall
+                continue;
+            }
+            i += step;
+            const struct AtlasGlyph *glyph = atlas_glyph(atlas, text_renderer->fonts, run->font, c);
+            if (!glyph || glyph->spilled) {
+                // Quads would leave a gap; the caller draws the whole line from a texture instead
+                free(line->quads);
+                line->quads = NULL;
+                line->quad_count = 0;
+                return false;
+            }
+            if (previous) {
+#ifdef TTF_HAS_UCS4
+                pen += TTF_GetFontKerningSizeGlyphs32(font, previous, c);
+#else
+                if (previous <= 0xFFFF && c <= 0xFFFF) {
+                    pen += TTF_GetFontKerningSizeGlyphs(font, (Uint16)previous, (Uint16)c);
+                }
+#endif
+            }
+            if (glyph->resident) {
+                struct GlyphQuad *quad = &line->quads[line->quad_count++];
+                quad->x = (float)(pen + glyph->x_offset);
+                quad->y = (float)glyph->y_offset;
+                quad->w = (float)glyph->src.w;
+                quad->h = (float)glyph->src.h;
+                quad->u0 = glyph->src.x * inv_w;
+                quad->v0 = glyph->src.y * inv_h;
+                quad->u1 = (glyph->src.x + glyph->src.w) * inv_w;
+                quad->v1 = (glyph->src.y + glyph->src.h) * inv_h;
+            }
+            pen += glyph->advance;
+            previous = c;
+        }
+    }
+
+    if (line->quad_count == 0) {
+        free(line->quads);
+        line->quads = NULL;
+        return false;
+    }
+    line->texture_width = pen;
+    line->texture_height = atlas->line_height;
+    return true;
+}
+
+static bool news_line_has_content(const struct NewsLine *line) {
+    return line->texture || line->quads || line->tiles;
+}
+
+void draw_news_lines(struct TextRenderer *text_renderer, const struct LanePool *pool, float alpha) {
+    SDL_Renderer *renderer = text_renderer->renderer;
+    struct GlyphAtlas *atlas = &text_renderer->atlas;
+    const int screen_width = pool->area.w;
+    const float origin = (float)pool->area.x;
+    int batched = 0;
+
+    // A spanning window holds several displays; keep each pool's text off its neighbours
+    SDL_RenderSetClipRect(renderer, &pool->area);
+    for (int i = 0; i < pool->count; ++i) {
+        const struct NewsLine *line = &pool->lines[i];
+        float lane_x = pool->prev_x[i] + (pool->x[i] - pool->prev_x[i]) * alpha;
+        if (lane_x > screen_width || lane_x + line->texture_width < 0) continue;
+        float x = origin + lane_x;
+        if (line->texture) {
+#if SDL_VERSION_ATLEAST(2, 0, 10)
+            SDL_FRect dstRect = { x, (float)line->y_position, (float)line->texture_width, (float)line->texture_height };
+            SDL_RenderCopyF(renderer, line->texture, NULL, &dstRect);
+#else
+            SDL_Rect dstRect = { (int)(x < 0.0f ? x - 0.5f : x + 0.5f), line->y_position, line->texture_width, line->texture_height };
+            SDL_RenderCopy(renderer, line->texture, NULL, &dstRect);
+#endif
+            continue;
+        }
+        if (line->tiles) {
+            const struct LineTiles *tiles = line->tiles;
+            for (int t = 0; t < tiles->count; ++t) {
+                if (!tiles->textures[t]) continue;
+                int left = t * tiles->tile_width;
+                int width = line->texture_width - left < tiles->tile_width ? line->texture_width - left : tiles->tile_width;
+#if SDL_VERSION_ATLEAST(2, 0, 10)
+                SDL_FRect tileRect = { x + (float)left, (float)line->y_position, (float)width, (float)line->texture_height };
+                SDL_RenderCopyF(renderer, tiles->textures[t], NULL, &tileRect);
+#else
+                float tile_x = x + (float)left;
+                SDL_Rect tileRect = { (int)(tile_x < 0.0f ? tile_x - 0.5f : tile_x + 0.5f), line->y_position, width, line->texture_height };
+                SDL_RenderCopy(renderer, tiles->textures[t], NULL, &tileRect);
+#endif
+            }
+            continue;
+        }
+        if (!line->quads) continue;
+
+        SDL_Color color = line->color;
+        for (int q = 0; q < line->quad_count; ++q) {
+            const struct GlyphQuad *quad = &line->quads[q];
+            float x0 = x + quad->x;
+            float x1 = x0 + quad->w;
+            if (x1 < origin || x0 > origin + (float)screen_width) continue;
+            float y0 = (float)line->y_position + quad->y;
+            float y1 = y0 + quad->h;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+            SDL_Vertex *v = &atlas->vertices[batched * 4];
+            v[0] = (SDL_Vertex){ { x0, y0 }, color, { quad->u0, quad->v0 } };
+            v[1] = (SDL_Vertex){ { x1, y0 }, color, { quad->u1, quad->v0 } };
+            v[2] = (SDL_Vertex){ { x0, y1 }, color, { quad->u0, quad->v1 } };
+            v[3] = (SDL_Vertex){ { x1, y1 }, color, { quad->u1, quad->v1 } };
+            if (++batched == GLYPH_BATCH_QUADS) {
+                SDL_RenderGeometry(renderer, atlas->texture, atlas->vertices, batched * 4, atlas->indices, batched * 6);
+                batched = 0;
+            }
+#else
+            // Pre-2.0.18 SDL has no geometry API; fall back to one copy per glyph
+            SDL_Rect src = { (int)(quad->u0 * atlas->width), (int)(quad->v0 * atlas->height), (int)quad->w, (int)quad->h };
+            SDL_Rect dst = { (int)x0, (int)y0, (int)quad->w, (int)quad->h };
+            SDL_SetTextureColorMod(atlas->texture, color.r, color.g, color.b);
+            SDL_RenderCopy(renderer, atlas->texture, &src, &dst);
+            (void)y1;
+#endif
+        }
+    }
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    if (batched > 0) {
+        SDL_RenderGeometry(renderer, atlas->texture, atlas->vertices, batched * 4, atlas->indices, batched * 6);
+    }
+#endif
+    SDL_RenderSetClipRect(renderer, NULL);
+}
+
+// FNV-1a; pass FNV_OFFSET_BASIS to start, or a previous result to chain fields
+static Uint64 hash_bytes(const void *data, size_t len, Uint64 hash) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < len; ++i) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+// Hashes the sanitized text, then the color and size that change the rasterized pixels
+static Uint64 texture_cache_key(const char *text, SDL_Color color, int font_size) {
+    Uint64 hash = hash_bytes(text, strlen(text), FNV_OFFSET_BASIS);
+    const Uint8 extra[] = { color.r, color.g, color.b, color.a, (Uint8)font_size, (Uint8)(font_size >> 8) };
+    return hash_bytes(extra, sizeof(extra), hash);
+}
+
+bool acquire_cached_texture(struct TextRenderer *text_renderer, struct NewsLine *line) {
+    struct TextureCache *cache = &text_renderer->cache;
+    Uint64 key = texture_cache_key(line->text, line->color, text_renderer->font_size);
+
+    for (int i = 0; i < cache->count; ++i) {
+        struct TextureCacheEntry *entry = cache->entries[i];
+        if (entry->key != key || entry->font_size != text_renderer->font_size) continue;
+        if (memcmp(&entry->color, &line->color, sizeof(SDL_Color)) != 0 || strcmp(entry->text, line->text) != 0) continue;
+
+        entry->refs++;
+        entry->last_used = ++cache->clock;
+        line->cached = entry;
+        line->texture = entry->texture;
+        line->texture_width = entry->width;
+        line->texture_height = entry->height;
+        cache->hits++;
+
+        // The texture can't be read back, so a line the next snapshot still wants is rendered once more for it
+        struct LineSnapshot *snapshot = text_renderer->snapshot;
+        if (snapshot && wanted_capture(snapshot, key, line->text)) {
+            SDL_Surface *surface = render_shaped_text(text_renderer->fonts, line->text, line->color);
+            capture_line_snapshot(snapshot, key, line, surface);
+            if (surface) SDL_FreeSurface(surface);
+        }
+        return true;
+    }
+
+    cache->misses++;
+    render_line_texture(text_renderer, line);
+    if (!line->texture) return false;
+
+    if (cache->count == cache->capacity) {
+        int capacity = cache->capacity > 0 ? cache->capacity * 2 : 32;
+        struct TextureCacheEntry **grown = realloc(cache->entries, sizeof(*grown) * (size_t)capacity);
+        if (!grown) return true; // Still usable, just not shared
+        cache->entries = grown;
+        cache->capacity = capacity;
+    }
+    struct TextureCacheEntry *entry = calloc(1, sizeof(*entry));
+    char *text_copy = entry ? malloc(strlen(line->text) + 1) : NULL;
+    if (!entry || !text_copy) {
+        free(entry);
+        return true;
+    }
+    strcpy(text_copy, line->text);
+
+    entry->key = key;
+    entry->text = text_copy;
+    entry->color = line->color;
+    entry->font_size = text_renderer->font_size;
+    entry->texture = line->texture;
+    entry->width = line->texture_width;
+    entry->height = line->texture_height;
+    entry->bytes = (size_t)line->texture_width * (size_t)line->texture_height * 4;
+    entry->refs = 1;
+    entry->last_used = ++cache->clock;
+    cache->entries[cache->count++] = entry;
+    cache->bytes += entry->bytes;
+    line->cached = entry;
+
+    trim_texture_cache(cache);
+    return true;
+}
+
+void trim_texture_cache(struct TextureCache *cache) {
+    evict_cached_textures(cache, cache->budget_bytes);
+}
+
+// Evicts least recently used textures no line references until the cache holds at most target_bytes
+static int evict_cached_textures(struct TextureCache *cache, size_t target_bytes) {
+    int evicted = 0;
+    while (cache->bytes > target_bytes) {
+        int victim = -1;
+        for (int i = 0; i < cache->count; ++i) {
+            const struct TextureCacheEntry *entry = cache->entries[i];
+            if (entry->refs > 0) continue;
+            if (victim < 0 || entry->last_used < cache->entries[victim]->last_used) {
+                victim = i;
+            }
+        }
+        if (victim < 0) break; // Everything left is on screen
+
+        struct TextureCacheEntry *entry = cache->entries[victim];
+        cache->bytes -= entry->bytes;
+        SDL_DestroyTexture(entry->texture);
+        free(entry->text);
+        free(entry);
+        cache->entries[victim] = cache->entries[--cache->count];
+        evicted++;
+    }
+    return evicted;
+}
+
+void destroy_texture_cache(struct TextureCache *cache) {
+    if (!cache) return;
+    for (int i = 0; i < cache->count; ++i) {
+        SDL_DestroyTexture(cache->entries[i]->texture);
+        free(cache->entries[i]->text);
+        free(cache->entries[i]);
+    }
+    free(cache->entries);
+    cache->entries = NULL;
+    cache->count = 0;
+    cache->capacity = 0;
+    cache->bytes = 0;
+}
+
+size_t texture_bytes_in_use(const struct TextRenderer *text_renderer) {
+    size_t atlas_bytes = text_renderer->atlas.texture ? (size_t)text_renderer->atlas.width * (size_t)text_renderer->atlas.height * 4 : 0;
+    return text_renderer->budget.line_bytes + text_renderer->cache.bytes + atlas_bytes;
+}
+
+// What rasterizing the line would add; a cache hit or an atlas layout adds nothing
+static size_t estimate_line_bytes(struct TextRenderer *text_renderer, const struct NewsLine *line) {
+    // Once the atlas is full a line may need its own texture; count it as if it would
+    if (text_renderer->mode == TEXT_RENDER_ATLAS && !text_renderer->atlas.full) return 0;
+    const struct TextureCache *cache = &text_renderer->cache;
+    if (cache->budget_bytes > 0 && text_renderer->mode == TEXT_RENDER_TEXTURE) {
+        Uint64 key = texture_cache_key(line->text, line->color, text_renderer->font_size);
+        for (int i = 0; i < cache->count; ++i) {
+            const struct TextureCacheEntry *entry = cache->entries[i];
+            if (entry->key == key && strcmp(entry->text, line->text) == 0) return 0;
+        }
+    }
+    const struct ShapedLine *shaped = shape_line(text_renderer->fonts, line->text);
+    if (!shaped) return 0;
+    int width = shaped->width;
+    int height = shaped->height;
+    // A tiled line arrives at the right edge, where only its first tile is in range
+    bool tiled = text_renderer->mode == TEXT_RENDER_TILED || line->deferrals >= TEXTURE_DEFERRAL_LIMIT ||
+                 (text_renderer->max_texture_width > 0 && width > text_renderer->max_texture_width);
+    if (tiled && width > text_renderer->tile_width) width = text_renderer->tile_width;
+    return (size_t)width * (size_t)height * 4;
+}
+
+// Frees what can go without anything visible changing: lanes past raster_edge first, farthest first, since
+// they rasterize again on arrival, then cached textures nothing shows. Lanes inside the edge are left alone;
+// refill_lanes would only rasterize them again in the same pass. False if the line still won't fit, in which
+// case nothing is freed, so a lane waiting for room doesn't strip the others of their textures every pass.
+static bool make_texture_room(struct TextRenderer *text_renderer, struct LanePool *pool, size_t bytes, float raster_edge) {
+    struct TextureBudget *budget = &text_renderer->budget;
+    size_t in_use = texture_bytes_in_use(text_renderer);
+    if (budget->limit_bytes == 0 || in_use + bytes <= budget->limit_bytes) return true;
+    size_t freeable = 0;
+    for (int i = 0; i < pool->count; ++i) {
+        if (pool->x[i] > raster_edge) freeable += line_owned_bytes(&pool->lines[i]);
+    }
+    const struct TextureCache *cache = &text_renderer->cache;
+    for (int i = 0; i < cache->count; ++i) {
+        if (cache->entries[i]->refs == 0) freeable += cache->entries[i]->bytes;
+    }
+    if (in_use - (freeable < in_use ? freeable : in_use) + bytes > budget->limit_bytes) return false;
+    for (;;) {
+        int farthest = -1;
+        for (int i = 0; i < pool->count; ++i) {
+            const struct NewsLine *line = &pool->lines[i];
+            if ((!line->texture && !line->tiles) || pool->x[i] <= raster_edge) continue;
+            if (farthest < 0 || pool->x[i] > pool->x[farthest]) farthest = i;
+        }
+        if (farthest < 0) break;
+        release_line_pixels(&pool->lines[farthest]);
+        budget->evictions++;
+        if (texture_bytes_in_use(text_renderer) + bytes <= budget->limit_bytes) return true;
+    }
+    in_use = texture_bytes_in_use(text_renderer);
+    size_t excess = in_use + bytes - budget->limit_bytes;
+    size_t target = text_renderer->cache.bytes > excess ? text_renderer->cache.bytes - excess : 0;
+    budget->evictions += evict_cached_textures(&text_renderer->cache, target);
+    return texture_bytes_in_use(text_renderer) + bytes <= budget->limit_bytes;
+}
+
+// Texture memory releasing the line's pixels gives back; a borrowed cache texture stays with the cache
+static size_t line_owned_bytes(const struct NewsLine *line) {
+    if (line->texture && !line->cached) return (size_t)line->texture_width * (size_t)line->texture_height * 4;
+    if (!line->tiles) return 0;
+    size_t bytes = 0;
+    const struct LineTiles *tiles = line->tiles;
+    for (int t = 0; t < tiles->count; ++t) {
+        if (!tiles->textures[t]) continue;
+        int left = t * tiles->tile_width;
+        int width = line->texture_width - left < tiles->tile_width ? line->texture_width - left : tiles->tile_width;
+        bytes += (size_t)width * (size_t)line->texture_height * 4;
+    }
+    return bytes;
+}
+
+// A failed allocation caps textures at what was held then; video memory may have come free since, so the
+// configured budget is tried again once the cap has held a while
+static void recover_texture_limit(struct TextureBudget *budget) {
+    if (budget->limit_bytes == budget->configured_bytes) return;
+    if (SDL_GetTicks() - budget->capped_at < TEXTURE_CAP_RECOVERY_MS) return;
+    budget->limit_bytes = budget->configured_bytes;
+    fprintf(stderr, "Lifting the texture cap back to the configured budget.\n");
+}
+
+static void account_line_texture(struct TextRenderer *text_renderer, struct NewsLine *line) {
+    struct TextureBudget *budget = &text_renderer->budget;
+    if (line->texture && !line->cached) {
+        line->budget = budget;
+        budget->line_bytes += (size_t)line->texture_width * (size_t)line->texture_height * 4;
+    }
+    size_t in_use = texture_bytes_in_use(text_renderer);
+    if (in_use > budget->peak_bytes) budget->peak_bytes = in_use;
+}
+
+static double ticks_to_ms(Uint64 ticks) {
+    return (double)ticks * 1000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+void init_frame_stats(struct FrameStats *stats, int refresh_rate) {
+    memset(stats, 0, sizeof(*stats));
+    stats->refresh_period_ms = 1000.0 / (refresh_rate > 0 ? refresh_rate : 60);
+}
+
+void record_frame(struct FrameStats *stats, const struct FrameSample *sample) {
+    stats->samples[stats->head] = *sample;
+    stats->head = (stats->head + 1) % FRAME_HISTORY;
+    if (stats->count < FRAME_HISTORY) stats->count++;
+    if (stats->unlogged < FRAME_HISTORY) stats->unlogged++;
+}
+
+static int compare_floats(const void *a, const void *b) {
+    float fa = *(const float *)a;
+    float fb = *(const float *)b;
+    return (fa > fb) - (fa < fb);
+}
+
+// Summarizes the most recent frames; a frame counts as late once it overruns its paced interval by half a refresh period
+void summarize_frames(const struct FrameStats *stats, int frames, struct FrameSummary *summary) {
+    memset(summary, 0, sizeof(*summary));
+    if (frames > stats->count) frames = stats->count;
+    if (frames <= 0) return;
+
+    float sorted[FRAME_HISTORY];
+    double frame_total = 0.0;
+    for (int i = 0; i < frames; ++i) {
+        const struct FrameSample *sample = &stats->samples[(stats->head - 1 - i + FRAME_HISTORY) % FRAME_HISTORY];
+        sorted[i] = sample->frame_ms;
+        frame_total += sample->frame_ms;
+        summary->update_ms += sample->update_ms;
+        summary->render_ms += sample->render_ms;
+        summary->present_ms += sample->present_ms;
+        if (sample->frame_ms > summary->frame_max_ms) summary->frame_max_ms = sample->frame_ms;
+
+        double target_ms = sample->target_ms > 0.0f ? sample->target_ms : stats->refresh_period_ms;
+        double overrun = (sample->frame_ms - target_ms) / stats->refresh_period_ms;
+        if (overrun > 0.5) {
+            summary->late++;
+            summary->dropped += (int)(overrun + 0.5);
+        }
+    }
+    qsort(sorted, (size_t)frames, sizeof(float), compare_floats);
+
+    summary->frames = frames;
+    summary->frame_avg_ms = (float)(frame_total / frames);
+    summary->frame_p99_ms = sorted[(frames * 99) / 100 < frames ? (frames * 99) / 100 : frames - 1];
+    summary->fps = frame_total > 0.0 ? (float)(frames * 1000.0 / frame_total) : 0.0f;
+    summary->update_ms /= frames;
+    summary->render_ms /= frames;
+    summary->present_ms /= frames;
+}
+
+void init_frame_pacer(struct FramePacer *pacer, const struct Config *config, int refresh_rate, SDL_Renderer *renderer) {
+    memset(pacer, 0, sizeof(*pacer));
+    if (refresh_rate <= 0) refresh_rate = 60;
+    pacer->refresh_ms = 1000.0 / refresh_rate;
+    pacer->adaptive = config->adaptive_pacing;
+    pacer->last_present = SDL_GetPerformanceCounter();
+
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(renderer, &info) == 0) {
+        pacer->vsync = (info.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
+        pacer->software = (info.flags & SDL_RENDERER_SOFTWARE) != 0;
+    }
+
+    int frame_rate = config->frame_rate;
+    if (frame_rate == 0 && pacer->software) frame_rate = SOFTWARE_FRAME_RATE;
+    pacer->min_interval = frame_rate > 0 ? (refresh_rate + frame_rate / 2) / frame_rate : 1;
+    if (pacer->min_interval < 1) pacer->min_interval = 1;
+    pacer->interval = pacer->min_interval;
+    pacer->load_interval = 1;
+    if (pacer->interval > 1 || pacer->adaptive || !pacer->vsync) {
+        fprintf(stdout, "Frame pacing: %.0f fps%s%s%s.\n", 1000.0 / pacing_target_ms(pacer), pacer->adaptive ? ", adaptive" : "",
+                pacer->vsync ? "" : ", timer paced", pacer->software ? ", software renderer" : "");
+    }
+}
+
+// Milliseconds until the next present is due, 0 once it is
+Uint32 pacing_wait_ms(const struct FramePacer *pacer) {
+    // Every vblank is wanted, so the present itself does the waiting
+    if (pacer->vsync && pacer->interval == 1) return 0;
+    // With vsync, aim half a period early and let the present snap to the vblank
+    double due_ms = pacer->vsync ? (pacer->interval - 0.5) * pacer->refresh_ms : pacing_target_ms(pacer);
+    double since_ms = ticks_to_ms(SDL_GetPerformanceCounter() - pacer->last_present);
+    return since_ms >= due_ms ? 0 : (Uint32)(due_ms - since_ms);
+}
+
+double pacing_target_ms(const struct FramePacer *pacer) {
+    return pacer->interval * pacer->refresh_ms;
+}
+
+// Called after every present. Adaptive pacing settles once per window on the slowest pace that keeps the fastest
+// lane stepping under PACING_MAX_STEP_PX, and backs off further while too many presents miss their vblank.
+void pace_frame(struct FramePacer *pacer, Uint64 presented, float frame_ms, float fastest_speed) {
+    double target_ms = pacing_target_ms(pacer);
+    pacer->last_present = presented;
+    bool late = frame_ms - target_ms > 0.5 * pacer->refresh_ms;
+    if (late) pacer->missed_total++;
+    if (!pacer->adaptive) return;
+
+    pacer->window_ms += frame_ms;
+    pacer->window_frames++;
+    if (late) pacer->window_late++;
+    if (pacer->window_ms < PACING_WINDOW_MS) return;
+
+    if (pacer->window_late * 100 > pacer->window_frames * PACING_LATE_PERCENT) {
+        if (pacer->load_interval < PACING_MAX_INTERVAL) pacer->load_interval++;
+        fprintf(stderr, "Frame pacing: %d of %d presents missed their vblank; slowing down.\n", pacer->window_late, pacer->window_frames);
+        pacer->clean_windows = 0;
+    } else if (pacer->window_late == 0 && pacer->load_interval > 1 && ++pacer->clean_windows >= PACING_RECOVER_WINDOWS) {
+        pacer->load_interval--;
+        pacer->clean_windows = 0;
+    }
+    pacer->window_ms = 0.0;
+    pacer->window_frames = 0;
+    pacer->window_late = 0;
+
+    int interval = PACING_MAX_INTERVAL;
+    if (fastest_speed > 0.0f) {
+        interval = (int)(PACING_MAX_STEP_PX * 1000.0 / (fastest_speed * pacer->refresh_ms));
+    }
+    if (interval < pacer->load_interval) interval = pacer->load_interval;
+    if (interval > PACING_MAX_INTERVAL) interval = PACING_MAX_INTERVAL;
+    if (interval < pacer->min_interval) interval = pacer->min_interval;
+    if (interval != pacer->interval) {
+        pacer->interval = interval;
+        fprintf(stdout, "Frame pacing: presenting at %.0f fps.\n", 1000.0 / pacing_target_ms(pacer));
+    }
+}
+
+static const char telemetry_csv_header[] = "time,uptime_ms,kind,name,frames,fps,frame_avg_ms,frame_p99_ms,frame_max_ms,update_ms,render_ms,present_ms,late,dropped,http_code,ok,dns_ms,connect_ms,tls_ms,wait_ms,transfer_ms,parse_ms,bytes,lines,rasterize_ms,cache_hits,cache_misses,texture_bytes,texture_peak_bytes,texture_limit_bytes,texture_evictions,texture_deferrals,texture_failures\n";
+
+bool open_telemetry_log(struct TelemetryLog *log, const struct Config *config) {
+    memset(log, 0, sizeof(*log));
+    if (!config->telemetry_path[0]) return false;
+
+    snprintf(log->path, sizeof(log->path), "%s", config->telemetry_path);
+    log->format = config->telemetry_format;
+    log->max_bytes = (long)config->telemetry_max_kb * 1024;
+    log->file = fopen(log->path, "a");
+    if (!log->file) {
+        fprintf(stderr, "Unable to open telemetry log %s.\n", log->path);
+        return false;
+    }
+    fseek(log->file, 0, SEEK_END);
+    log->written = ftell(log->file);
+    if (log->written <= 0 && log->format == TELEMETRY_CSV) {
+        log->written = 0;
+        write_telemetry_line(log, telemetry_csv_header);
+    }
+    return true;
+}
+
+void close_telemetry_log(struct TelemetryLog *log) {
+    if (log->file) {
+        fclose(log->file);
+        log->file = NULL;
+    }
+}
+
+// Appends one record, rotating the file to <path>.1 when it outgrows its budget
+static void write_telemetry_line(struct TelemetryLog *log, const char *line) {
+    if (!log->file) return;
+    if (fputs(line, log->file) >= 0) {
+        log->written += (long)strlen(line);
+    }
+    // Records are at most one per second per kind, so flushing each keeps the log live without real cost
+    fflush(log->file);
+    if (log->written < log->max_bytes) return;
+
+    fclose(log->file);
+    char rotated[sizeof(log->path) + 4];
+    snprintf(rotated, sizeof(rotated), "%s.1", log->path);
+    remove(rotated);
+    rename(log->path, rotated);
+    log->file = fopen(log->path, "w");
+    log->written = 0;
+    if (log->file && log->format == TELEMETRY_CSV) {
+        write_telemetry_line(log, telemetry_csv_header);
+    }
+}
+
+static void write_telemetry_json(struct TelemetryLog *log, cJSON *record, const char *kind) {
+    if (!record) return;
+    cJSON_AddNumberToObject(record, "time", (double)time(NULL));
+    cJSON_AddNumberToObject(record, "uptime_ms", SDL_GetTicks());
+    cJSON_AddStringToObject(record, "kind", kind);
+    char *text = cJSON_PrintUnformatted(record);
+    if (text) {
+        write_telemetry_line(log, text);
+        write_telemetry_line(log, "\n");
+        free(text);
+    }
+    cJSON_Delete(record);
+}
+
+void log_frame_telemetry(struct TelemetryLog *log, const struct FrameSummary *summary) {
+    if (!log->file || summary->frames == 0) return;
+    if (log->format == TELEMETRY_JSON) {
+        cJSON *record = cJSON_CreateObject();
+        if (!record) return;
+        cJSON_AddNumberToObject(record, "frames", summary->frames);
+        cJSON_AddNumberToObject(record, "fps", summary->fps);
+        cJSON_AddNumberToObject(record, "frame_avg_ms", summary->frame_avg_ms);
+        cJSON_AddNumberToObject(record, "frame_p99_ms", summary->frame_p99_ms);
+        cJSON_AddNumberToObject(record, "frame_max_ms", summary->frame_max_ms);
+        cJSON_AddNumberToObject(record, "update_ms", summary->update_ms);
+        cJSON_AddNumberToObject(record, "render_ms", summary->render_ms);
+        cJSON_AddNumberToObject(record, "present_ms", summary->present_ms);
+        cJSON_AddNumberToObject(record, "late", summary->late);
+        cJSON_AddNumberToObject(record, "dropped", summary->dropped);
+        write_telemetry_json(log, record, "frames");
+        return;
+    }
+    char line[512];
+    snprintf(line, sizeof(line), "%lld,%u,frames,,%d,%.2f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%d,,,,,,,,,,,,,,,,,,,\n",
+             (long long)time(NULL), SDL_GetTicks(), summary->frames, summary->fps, summary->frame_avg_ms, summary->frame_p99_ms,
+             summary->frame_max_ms, summary->update_ms, summary->render_ms, summary->present_ms, summary->late, summary->dropped);
+    write_telemetry_line(log, line);
+}
+
+void log_refresh_telemetry(struct TelemetryLog *log, const struct RefreshMetrics *metrics) {
+    if (!log->file) return;
+    for (int i = 0; i < metrics->source_count; ++i) {
+        const struct SourceTiming *timing = &metrics->sources[i];
+        if (log->format == TELEMETRY_JSON) {
+            cJSON *record = cJSON_CreateObject();
+            if (!record) return;
+            cJSON_AddStringToObject(record, "name", timing->name);
+            cJSON_AddNumberToObject(record, "http_code", timing->http_code);
+            cJSON_AddBoolToObject(record, "ok", timing->ok);
+            cJSON_AddNumberToObject(record, "dns_ms", timing->dns_ms);
+            cJSON_AddNumberToObject(record, "connect_ms", timing->connect_ms);
+            cJSON_AddNumberToObject(record, "tls_ms", timing->tls_ms);
+            cJSON_AddNumberToObject(record, "wait_ms", timing->wait_ms);
+            cJSON_AddNumberToObject(record, "transfer_ms", timing->transfer_ms);
+            cJSON_AddNumberToObject(record, "parse_ms", timing->parse_ms);
+            cJSON_AddNumberToObject(record, "bytes", (double)timing->bytes);
+            write_telemetry_json(log, record, "source");
+            continue;
+        }
+        char line[512];
+        snprintf(line, sizeof(line), "%lld,%u,source,%s,,,,,,,,,,,%ld,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%zu,,,,,,,,,,\n",
+                 (long long)time(NULL), SDL_GetTicks(), timing->name, timing->http_code, timing->ok ? 1 : 0, timing->dns_ms,
+                 timing->connect_ms, timing->tls_ms, timing->wait_ms, timing->transfer_ms, timing->parse_ms, timing->bytes);
+        write_telemetry_line(log, line);
+    }
+}
+
+void log_rebuild_telemetry(struct TelemetryLog *log, int lines, double rasterize_ms, int cache_hits, int cache_misses) {
+    if (!log->file) return;
+    if (log->format == TELEMETRY_JSON) {
+        cJSON *record = cJSON_CreateObject();
+        if (!record) return;
+        cJSON_AddNumberToObject(record, "lines", lines);
+        cJSON_AddNumberToObject(record, "rasterize_ms", rasterize_ms);
+        cJSON_AddNumberToObject(record, "cache_hits", cache_hits);
+        cJSON_AddNumberToObject(record, "cache_misses", cache_misses);
+        write_telemetry_json(log, record, "rebuild");
+        return;
+    }
+    char line[256];
+    snprintf(line, sizeof(line), "%lld,%u,rebuild,,,,,,,,,,,,,,,,,,,,,%d,%.3f,%d,%d,,,,,,\n",
+             (long long)time(NULL), SDL_GetTicks(), lines, rasterize_ms, cache_hits, cache_misses);
+    write_telemetry_line(log, line);
+}
+
+void log_texture_telemetry(struct TelemetryLog *log, const struct TextureBudget *totals, size_t bytes) {
+    if (!log->file) return;
+    if (log->format == TELEMETRY_JSON) {
+        cJSON *record = cJSON_CreateObject();
+        if (!record) return;
+        cJSON_AddNumberToObject(record, "texture_bytes", (double)bytes);
+        cJSON_AddNumberToObject(record, "texture_peak_bytes", (double)totals->peak_bytes);
+        cJSON_AddNumberToObject(record, "texture_limit_bytes", (double)totals->limit_bytes);
+        cJSON_AddNumberToObject(record, "texture_evictions", totals->evictions);
+        cJSON_AddNumberToObject(record, "texture_deferrals", totals->deferrals);
+        cJSON_AddNumberToObject(record, "texture_failures", totals->failures);
+        write_telemetry_json(log, record, "textures");
+        return;
+    }
+    char line[256];
+    snprintf(line, sizeof(line), "%lld,%u,textures,,,,,,,,,,,,,,,,,,,,,,,,,%zu,%zu,%zu,%d,%d,%d\n",
+             (long long)time(NULL), SDL_GetTicks(), bytes, totals->peak_bytes, totals->limit_bytes, totals->evictions, totals->deferrals, totals->failures);
+    write_telemetry_line(log, line);
+}
+
+void update_hud(struct Hud *hud, SDL_Renderer *renderer, const struct FrameStats *stats, int screen_width) {
+    if (!hud->font) return;
+
+    struct FrameSummary summary;
+    summarize_frames(stats, stats->count, &summary);
+
+    char text[1024];
+    int len = snprintf(text, sizeof(text),
+                       "%.1f fps  frame avg %.2f  p99 %.2f  max %.2f ms  (%d frames)\n"
+                       "update %.3f  render %.3f  present %.3f ms  late %d  dropped %d  paced %.0f fps\n"
+                       "rebuild: %d headlines loaded in %.2f ms  (%d new, %d gone, %d duplicates)\n"
+                       "textures %.1f MB  peak %.1f  limit %.1f MB  evicted %d  deferred %d  failed %d",
+                       summary.fps, summary.frame_avg_ms, summary.frame_p99_ms, summary.frame_max_ms, summary.frames,
+                       summary.update_ms, summary.render_ms, summary.present_ms, summary.late, summary.dropped, hud->paced_fps,
+                       hud->rebuild_lines, hud->rasterize_ms, hud->rebuild_diff.added, hud->rebuild_diff.removed, hud->rebuild_diff.duplicates,
+                       hud->texture_bytes / (1024.0 * 1024.0), hud->textures.peak_bytes / (1024.0 * 1024.0),
+                       hud->textures.limit_bytes / (1024.0 * 1024.0), hud->textures.evictions, hud->textures.deferrals, hud->textures.failures);
+    for (int i = 0; hud->has_refresh && i < hud->refresh.source_count && len > 0 && (size_t)len < sizeof(text); ++i) {
+        const struct SourceTiming *timing = &hud->refresh.sources[i];
+        len += snprintf(text + len, sizeof(text) - (size_t)len,
+                        "\n%s %ld%s: dns %.1f  connect %.1f  tls %.1f  wait %.1f  transfer %.1f  parse %.2f ms",
+                        timing->name, timing->http_code, timing->ok ? "" : " (failed)", timing->dns_ms, timing->connect_ms,
+                        timing->tls_ms, timing->wait_ms, timing->transfer_ms, timing->parse_ms);
+    }
+
+    if (hud->texture) {
+        SDL_DestroyTexture(hud->texture);
+        hud->texture = NULL;
+    }
+    SDL_Surface *surface = TTF_RenderText_Blended_Wrapped(hud->font, text, (SDL_Color){220, 220, 220, 255}, (Uint32)screen_width);
+    if (!surface) return;
+    hud->texture = SDL_CreateTextureFromSurface(renderer, surface);
+    hud->width = surface->w;
+    hud->height = surface->h;
+    SDL_FreeSurface(surface);
+}
+
+void draw_hud(const struct Hud *hud, SDL_Renderer *renderer) {
+    if (!hud->visible || !hud->texture) return;
+    SDL_Rect backdrop = { 0, 0, hud->width + 16, hud->height + 16 };
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
+    SDL_RenderFillRect(renderer, &backdrop);
+    SDL_Rect dst = { 8, 8, hud->width, hud->height };
+    SDL_RenderCopy(renderer, hud->texture, NULL, &dst);
+}
+
+void destroy_hud(struct Hud *hud) {
+    if (hud->texture) {
+        SDL_DestroyTexture(hud->texture);
+        hud->texture = NULL;
+    }
+    if (hud->font) {
+        TTF_CloseFont(hud->font);
+        hud->font = NULL;
+    }
+}
+
+bool parse_arguments(int argc, char *argv[], struct LaunchOptions *options) {
+    memset(options, 0, sizeof(*options));
+    options->bench_frames = BENCH_DEFAULT_FRAMES;
+    options->bench_refreshes = BENCH_DEFAULT_REFRESHES;
+    options->bench_fixture = BENCH_DEFAULT_FIXTURE;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (strcmp(arg, "--bench") == 0) {
+            options->bench = true;
+        } else if (strcmp(arg, "--frames") == 0 && has_value) {
+            options->bench_frames = atoi(argv[++i]);
+        } else if (strcmp(arg, "--refreshes") == 0 && has_value) {
+            options->bench_refreshes = atoi(argv[++i]);
+        } else if (strcmp(arg, "--fixture") == 0 && has_value) {
+            options->bench_fixture = argv[++i];
+        } else if (strcmp(arg, "--verbose") == 0) {
+            options->verbose = true;
+        } else if (strcmp(arg, "--seed") == 0 && has_value) {
+            options->has_seed = true;
+            options->seed = (Uint64)strtoull(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "Usage: %s [--seed N] [--verbose] [--bench [--frames N] [--refreshes N] [--fixture PATH]]\n", argv[0]);
+            return false;
+        }
+    }
+    if (options->bench_frames <= 0 || options->bench_refreshes <= 0) {
+        fprintf(stderr, "--frames and --refreshes must be positive.\n");
+        return false;
+    }
+    return true;
+}
+
+static bool read_file(const char *path, struct MemoryStruct *out) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return false;
+    fseek(file, 0, SEEK_END);
+    long len = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (len <= 0 || !reserve_memory(out, (size_t)len + 1)) {
+        fclose(file);
+        return false;
+    }
+    out->size = fread(out->memory, 1, (size_t)len, file);
+    out->memory[out->size] = '\0';
+    fclose(file);
+    return out->size > 0;
+}
+
+static double peak_rss_mb(void) {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0.0;
+    return counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0); // Bytes on macOS
+#else
+    return usage.ru_maxrss / 1024.0; // Kilobytes on Linux and the BSDs
+#endif
+#endif
+}
+
+static float percentile(const float *sorted, int count, float fraction) {
+    int index = (int)(fraction * (float)(count - 1) + 0.5f);
+    if (index < 0) index = 0;
+    if (index >= count) index = count - 1;
+    return sorted[index];
+}
+
+// Replays a recorded feed through parsing, rasterization and the scroll loop with no network and no vsync,
+// so runs on different builds and machines are directly comparable
+int run_benchmark(struct Config *config, const struct LaunchOptions *options) {
+    // Headless by default; exporting SDL_VIDEODRIVER overrides the hint to bench a real GPU driver
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+    SDL_SetHint(SDL_HINT_RENDER_VSYNC, "0");
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
+
+    struct MemoryStruct fixture = {0};
+    if (!read_file(options->bench_fixture, &fixture)) {
+        fprintf(stderr, "Unable to read benchmark fixture %s.\n", options->bench_fixture);
+        free_memory(&fixture);
+        return 1;
+    }
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        fprintf(stderr, "SDL could not initialize! SDL_Error: %s\n", SDL_GetError());
+        free_memory(&fixture);
+        return 1;
+    }
+    if (TTF_Init() == -1) {
+        fprintf(stderr, "SDL_ttf could not initialize! TTF_Error: %s\n", TTF_GetError());
+        SDL_Quit();
+        free_memory(&fixture);
+        return 1;
+    }
+
+    int exit_code = 1;
+    SDL_Window *window = SDL_CreateWindow("News Ticker (bench)", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, BENCH_WIDTH, BENCH_HEIGHT, SDL_WINDOW_HIDDEN);
+    SDL_Renderer *renderer = window ? SDL_CreateRenderer(window, -1, 0) : NULL;
+    struct FontChain fonts = {0};
+    TTF_Font *font = renderer && open_font_chain(&fonts, config, NULL) ? fonts.fonts[0] : NULL;
+    struct FeedSource *source = calloc(1, sizeof(*source));
+    struct HeadlineStore *stores = calloc(2, sizeof(*stores));
+    struct LanePool lanes = {0};
+    SDL_Rect bench_area = { 0, 0, BENCH_WIDTH, BENCH_HEIGHT };
+    float *parse_ms = malloc(sizeof(float) * (size_t)options->bench_refreshes);
+    float *build_ms = malloc(sizeof(float) * (size_t)options->bench_refreshes);
+    float *frame_ms = malloc(sizeof(float) * (size_t)options->bench_frames);
+    struct TextRenderer text_renderer = {0};
+    if (!font || !source || !stores || !init_lane_pool(&lanes, font, bench_area, options->has_seed ? options->seed : BENCH_DEFAULT_SEED, 0, config) || !parse_ms || !build_ms || !frame_ms) {
+        fprintf(stderr, "Benchmark setup failed: %s\n", SDL_GetError());
+        goto cleanup;
+    }
+    SDL_RendererInfo info = {0};
+    SDL_GetRendererInfo(renderer, &info);
+    init_text_renderer(&text_renderer, renderer, &fonts, config);
+
+    snprintf(source->name, sizeof(source->name), "Fixture");
+    source->format = FEED_FORMAT_JSON;
+    source->schema = &newsapi_schema;
+
+    // --- Refresh cost: parse plus rasterize, the first one cold and the rest against a warm cache ---
+    struct HeadlineStore *front_store = &stores[0];
+    struct HeadlineStore *back_store = &stores[1];
+    for (int r = 0; r < options->bench_refreshes; ++r) {
+        struct HeadlineBatch *batch = calloc(1, sizeof(*batch));
+        if (!batch) goto cleanup;
+        batch->limit = config->max_headlines;
+        Uint64 parse_start = SDL_GetPerformanceCounter();
+        int parsed = parse_feed_body(source, fixture.memory, fixture.size, batch);
+        Uint64 build_start = SDL_GetPerformanceCounter();
+        if (parsed == 0) {
+            fprintf(stderr, "Fixture %s has no usable headlines (%s).\n", options->bench_fixture, batch->error);
+            free_headline_batch(batch);
+            goto cleanup;
+        }
+        char status[STATUS_BUFFER];
+        build_headline_store(config, &text_renderer, back_store, front_store, batch, "", status, sizeof(status));
+        attach_headline_store(&lanes, back_store, true);
+        fill_empty_lanes(&lanes, back_store, config);
+        // Rasterize every lane up front so the figure stays comparable to a full refresh
+        refill_lanes(&lanes, back_store, &text_renderer, FLT_MAX, config);
+        Uint64 build_end = SDL_GetPerformanceCounter();
+        free_headline_batch(batch);
+        parse_ms[r] = (float)ticks_to_ms(build_start - parse_start);
+        build_ms[r] = (float)ticks_to_ms(build_end - build_start);
+
+        struct HeadlineStore *retired = front_store;
+        front_store = back_store;
+        back_store = retired;
+        reset_headline_store(back_store);
+        trim_texture_cache(&text_renderer.cache);
+    }
+
+    // --- Frame loop: simulated 60 Hz frames so every run scrolls the same distance ---
+    Uint64 frames_start = SDL_GetPerformanceCounter();
+    double scroll_accumulator = 0.0;
+    for (int f = 0; f < options->bench_frames; ++f) {
+        Uint64 frame_start = SDL_GetPerformanceCounter();
+        scroll_accumulator += 1.0 / 60.0;
+        float alpha;
+        step_news_lines(&lanes, drain_scroll_steps(&scroll_accumulator, &alpha));
+        refill_lanes(&lanes, front_store, &text_renderer, 0.0f, config);
+        SDL_SetRenderDrawColor(renderer, config->background_color.r, config->background_color.g, config->background_color.b, 255);
+        SDL_RenderClear(renderer);
+        draw_news_lines(&text_renderer, &lanes, alpha);
+        SDL_RenderPresent(renderer);
+        frame_ms[f] = (float)ticks_to_ms(SDL_GetPerformanceCounter() - frame_start);
+    }
+    double total_ms = ticks_to_ms(SDL_GetPerformanceCounter() - frames_start);
+
+    qsort(frame_ms, (size_t)options->bench_frames, sizeof(float), compare_floats);
+    float first_parse = parse_ms[0];
+    float first_build = build_ms[0];
+    qsort(parse_ms, (size_t)options->bench_refreshes, sizeof(float), compare_floats);
+    qsort(build_ms, (size_t)options->bench_refreshes, sizeof(float), compare_floats);
+
+    fprintf(stdout, "Benchmark: %d frames at %dx%d, %d headlines on %d lanes, %s text, %s video / %s renderer\n",
+            options->bench_frames, BENCH_WIDTH, BENCH_HEIGHT, front_store->count, lanes.count,
+            text_renderer.mode == TEXT_RENDER_ATLAS ? "atlas" : text_renderer.mode == TEXT_RENDER_TILED ? "tiled" : "texture",
+            SDL_GetCurrentVideoDriver() ? SDL_GetCurrentVideoDriver() : "unknown", info.name ? info.name : "unknown");
+    fprintf(stdout, "  frames per second : %.1f\n", total_ms > 0.0 ? options->bench_frames * 1000.0 / total_ms : 0.0);
+    fprintf(stdout, "  frame time p50    : %.3f ms\n", percentile(frame_ms, options->bench_frames, 0.50f));
+    fprintf(stdout, "  frame time p99    : %.3f ms\n", percentile(frame_ms, options->bench_frames, 0.99f));
+    fprintf(stdout, "  refresh parse     : %.3f ms first, %.3f ms median of %d\n", first_parse, percentile(parse_ms, options->bench_refreshes, 0.50f), options->bench_refreshes);
+    fprintf(stdout, "  refresh rasterize : %.3f ms first, %.3f ms median of %d\n", first_build, percentile(build_ms, options->bench_refreshes, 0.50f), options->bench_refreshes);
+    fprintf(stdout, "  peak RSS          : %.1f MB\n", peak_rss_mb());
+    fprintf(stdout, "  texture peak      : %.1f MB\n", text_renderer.budget.peak_bytes / (1024.0 * 1024.0));
+    fprintf(stdout, "  shaped lines      : %d itemized, %d reused (%d fonts)\n", fonts.shape_misses, fonts.shape_hits, fonts.count);
+    fprintf(stdout, "  layout seed       : %llu\n", (unsigned long long)(options->has_seed ? options->seed : BENCH_DEFAULT_SEED));
+    exit_code = 0;
+
+cleanup:
+    destroy_lane_pool(&lanes);
+    if (stores) {
+        for (int i = 0; i < 2; ++i) {
+            free_headline_store(&stores[i]);
+        }
+    }
+    if (source) {
+        json_scanner_free(&source->receiver.scanner);
+    }
+    destroy_glyph_atlas(&text_renderer.atlas);
+    destroy_texture_cache(&text_renderer.cache);
+    free(stores);
+    free(source);
+    free(parse_ms);
+    free(build_ms);
+    free(frame_ms);
+    free_memory(&fixture);
+    close_font_chain(&fonts);
+    if (renderer) SDL_DestroyRenderer(renderer);
+    if (window) SDL_DestroyWindow(window);
+    TTF_Quit();
+    SDL_Quit();
+    return exit_code;
+}
+
+void trim_whitespace(char *str) {
+    if (!str) return;
+    char *start = str;
+    while (isspace((unsigned char)*start)) {
+        start++;
+    }
+
+    memmove(str, start, strlen(start) + 1);
+
+    char *end = str + strlen(str) - 1;
+    while (end >= str && isspace((unsigned char)*end)) {
+        end--;
+    }
+    *(end + 1) = '\0';
+}
+
+
+bool parse_config(struct Config* config, char *error_message, size_t message_len) {
+    if (error_message && message_len > 0) {
+        error_message[0] = '\0';
+    }
+
+    // Set defaults first; zeroing the padding too lets a reload compare whole configs
+    memset(config, 0, sizeof(*config));
+    strcpy(config->api_key, "YOUR_API_KEY");
+    strcpy(config->font_path, "font.ttf");
+    strcpy(config->country_code, "us"); // Default to US
+    config->font_size = 28;
+    config->refresh_interval_seconds = DEFAULT_REFRESH_INTERVAL_SECONDS;
+    config->line_padding = DEFAULT_LINE_PADDING;
+    config->scroll_speed_min = DEFAULT_SCROLL_SPEED_MIN;
+    config->scroll_speed_max = DEFAULT_SCROLL_SPEED_MAX;
+    config->background_color = (SDL_Color){20, 20, 20, 255};
+    config->colors[0] = (SDL_Color){255, 165, 0, 255}; // Amber
+    config->colors[1] = (SDL_Color){0, 255, 255, 255};   // Cyan
+    config->colors[2] = (SDL_Color){255, 255, 0, 255};   // Yellow
+    config->colors[3] = (SDL_Color){0, 255, 0, 255};     // Green
+    config->colors[4] = (SDL_Color){255, 0, 255, 255};   // Magenta
+    config->num_colors = 5;
+    config->text_render_mode = TEXT_RENDER_TEXTURE;
+    config->display_layout = DISPLAY_PRIMARY;
+    config->texture_cache_mb = DEFAULT_TEXTURE_CACHE_MB;
+    config->texture_budget_mb = 0;
+    strcpy(config->response_cache_path, DEFAULT_RESPONSE_CACHE_PATH);
+    strcpy(config->snapshot_path, DEFAULT_SNAPSHOT_PATH);
+    snprintf(config->fallback_fonts, sizeof(config->fallback_fonts), "%s", DEFAULT_FALLBACK_FONTS);
+    config->source_newsapi = true;
+    config->source_guardian = false;
+    config->source_rss = false;
+    strcpy(config->guardian_api_key, "test"); // The Guardian's public, rate-limited developer key
+    strcpy(config->guardian_query, "uk");
+    config->num_rss_urls = 0;
+    config->source_timeout_ms = DEFAULT_SOURCE_TIMEOUT_MS;
+    config->max_headlines = DEFAULT_MAX_HEADLINES;
+    config->show_hud = false;
+    config->idle_when_static = true;
+    config->telemetry_path[0] = '\0';
+    config->telemetry_format = TELEMETRY_CSV;
+    config->telemetry_max_kb = DEFAULT_TELEMETRY_MAX_KB;
+    config->control_port = 0;
+    config->push_source[0] = '\0';
+
+    bool valid = true;
+    FILE* file = fopen(CONFIG_FILE, "r");
+    if (!file) {
+        append_message(error_message, message_len, "config.ini missing; using defaults.");
+        return false;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r' || line[0] == 0) {
+            continue;
+        }
+
+        char *key = strtok(line, "=");
+        char *value = strtok(NULL, "\n");
+
+        if (key && value) {
+            trim_whitespace(key);
+            trim_whitespace(value);
+
+            if (strcmp(key, "api_key") == 0) strcpy(config->api_key, value);
+            else if (strcmp(key, "font_path") == 0) strcpy(config->font_path, value);
+            else if (strcmp(key, "fallback_fonts") == 0) snprintf(config->fallback_fonts, sizeof(config->fallback_fonts), "%s", value);
+            else if (strcmp(key, "font_size") == 0) config->font_size = atoi(value);
+            else if (strcmp(key, "country_code") == 0) strncpy(config->country_code, value, sizeof(config->country_code) - 1);
+            else if (strcmp(key, "refresh_interval_seconds") == 0) config->refresh_interval_seconds = atoi(value);
+            else if (strcmp(key, "line_padding") == 0) config->line_padding = atoi(value);
+            else if (strcmp(key, "scroll_speed_min") == 0) config->scroll_speed_min = (float)atof(value);
+            else if (strcmp(key, "scroll_speed_max") == 0) config->scroll_speed_max = (float)atof(value);
+            else if (strcmp(key, "texture_cache_mb") == 0) config->texture_cache_mb = atoi(value);
+            else if (strcmp(key, "texture_budget_mb") == 0) config->texture_budget_mb = atoi(value);
+            else if (strcmp(key, "response_cache_path") == 0) snprintf(config->response_cache_path, sizeof(config->response_cache_path), "%s", value);
+            else if (strcmp(key, "snapshot_path") == 0) snprintf(config->snapshot_path, sizeof(config->snapshot_path), "%s", value);
+            else if (strcmp(key, "guardian_api_key") == 0) snprintf(config->guardian_api_key, sizeof(config->guardian_api_key), "%s", value);
+            else if (strcmp(key, "guardian_query") == 0) snprintf(config->guardian_query, sizeof(config->guardian_query), "%s", value);
+            else if (strcmp(key, "source_timeout_ms") == 0) config->source_timeout_ms = atoi(value);
+            else if (strcmp(key, "max_headlines") == 0) config->max_headlines = atoi(value);
+            else if (strcmp(key, "show_hud") == 0) config->show_hud = atoi(value) != 0;
+            else if (strcmp(key, "idle_when_static") == 0) config->idle_when_static = atoi(value) != 0;
+            else if (strcmp(key, "frame_rate") == 0) {
+                config->adaptive_pacing = strcmp(value, "auto") == 0;
+                config->frame_rate = config->adaptive_pacing || strcmp(value, "display") == 0 ? 0 : atoi(value);
+            }
+            else if (strcmp(key, "telemetry_path") == 0) snprintf(config->telemetry_path, sizeof(config->telemetry_path), "%s", value);
+            else if (strcmp(key, "telemetry_max_kb") == 0) config->telemetry_max_kb = atoi(value);
+            else if (strcmp(key, "control_port") == 0) config->control_port = atoi(value);
+            else if (strcmp(key, "push_source") == 0) snprintf(config->push_source, sizeof(config->push_source), "%s", value);
+            else if (strcmp(key, "telemetry_format") == 0) {
+                if (strcmp(value, "csv") == 0) config->telemetry_format = TELEMETRY_CSV;
+                else if (strcmp(value, "json") == 0) config->telemetry_format = TELEMETRY_JSON;
+                else {
+                    append_message(error_message, message_len, "telemetry_format must be 'csv' or 'json'; using csv.");
+                    valid = false;
+                }
+            }
+            else if (strcmp(key, "rss_url") == 0) {
+                if (config->num_rss_urls < MAX_RSS_FEEDS) {
+                    snprintf(config->rss_urls[config->num_rss_urls++], sizeof(config->rss_urls[0]), "%s", value);
+                } else {
+                    append_message(error_message, message_len, "Too many rss_url entries; extra feeds ignored.");
+                    valid = false;
+                }
+            }
+            else if (strcmp(key, "sources") == 0) {
+                config->source_newsapi = false;
+                config->source_guardian = false;
+                config->source_rss = false;
+                // The line is fully split already, so strtok can be reused on the value
+                for (char *name = strtok(value, ","); name; name = strtok(NULL, ",")) {
+                    trim_whitespace(name);
+                    if (strcmp(name, "newsapi") == 0) config->source_newsapi = true;
+                    else if (strcmp(name, "guardian") == 0) config->source_guardian = true;
+                    else if (strcmp(name, "rss") == 0) config->source_rss = true;
+                    else if (name[0] != '\0') {
+                        append_message(error_message, message_len, "sources accepts newsapi, guardian and rss.");
+                        valid = false;
+                    }
+                }
+            }
+            else if (strcmp(key, "headline_colors") == 0) {
+                if (!parse_color_list(value, config)) {
+                    append_message(error_message, message_len, "headline_colors must list RRGGBB hex colors; using defaults.");
+                    valid = false;
+                }
+            }
+            else if (strcmp(key, "background_color") == 0) {
+                if (!parse_hex_color(value, &config->background_color)) {
+                    append_message(error_message, message_len, "background_color must be an RRGGBB hex color; using default.");
+                    valid = false;
+                }
+            }
+            else if (strcmp(key, "text_renderer") == 0) {
+                if (strcmp(value, "atlas") == 0) config->text_render_mode = TEXT_RENDER_ATLAS;
+                else if (strcmp(value, "texture") == 0) config->text_render_mode = TEXT_RENDER_TEXTURE;
+                else if (strcmp(value, "tiled") == 0) config->text_render_mode = TEXT_RENDER_TILED;
+                else {
+                    append_message(error_message, message_len, "text_renderer must be 'texture', 'atlas' or 'tiled'; using texture.");
+                    valid = false;
+                }
+            }
+            else if (strcmp(key, "displays") == 0) {
+                if (strcmp(value, "primary") == 0) config->display_layout = DISPLAY_PRIMARY;
+                else if (strcmp(value, "each") == 0) config->display_layout = DISPLAY_EACH;
+                else if (strcmp(value, "span") == 0) config->display_layout = DISPLAY_SPAN;
+                else {
+                    append_message(error_message, message_len, "displays must be 'primary', 'each' or 'span'; using primary.");
+                    valid = false;
+                }
+            }
+        }
+    }
+    fclose(file);
+
+    // Normalize country code to lowercase
+    for (size_t i = 0; config->country_code[i] != '\0'; ++i) {
         config->country_code[i] = (char)tolower((unsigned char)config->country_code[i]);
     }
 
-    if (strcmp(config->api_key, "YOUR_API_KEY") == 0 || strlen(config->api_key) < 8) {
-        append_message(error_message, message_len, "Set a valid api_key in config.ini.");
-        valid = false;
+    if (config->source_rss && config->num_rss_urls == 0) {
+        append_message(error_message, message_len, "sources lists rss but no rss_url is set.");
+        config->source_rss = false;
+        valid = false;
+    }
+
+    if (!config->source_newsapi && !config->source_guardian && !config->source_rss) {
+        append_message(error_message, message_len, "No news sources enabled; using newsapi.");
+        config->source_newsapi = true;
+        valid = false;
+    }
+
+    if (config->source_newsapi && (strcmp(config->api_key, "YOUR_API_KEY") == 0 || strlen(config->api_key) < 8)) {
+        append_message(error_message, message_len, "Set a valid api_key in config.ini.");
+        valid = false;
+    }
+
+    if (config->guardian_api_key[0] == '\0') {
+        strcpy(config->guardian_api_key, "test");
+    }
+
+    if (config->telemetry_max_kb <= 0) {
+        append_message(error_message, message_len, "telemetry_max_kb must be positive; using default.");
+        config->telemetry_max_kb = DEFAULT_TELEMETRY_MAX_KB;
+        valid = false;
+    }
+
+    if (config->source_timeout_ms <= 0) {
+        append_message(error_message, message_len, "source_timeout_ms must be positive; using default.");
+        config->source_timeout_ms = DEFAULT_SOURCE_TIMEOUT_MS;
+        valid = false;
+    }
+
+    if (config->max_headlines <= 0) {
+        append_message(error_message, message_len, "max_headlines must be positive; using default.");
+        config->max_headlines = DEFAULT_MAX_HEADLINES;
+        valid = false;
+    }
+
+    if (config->font_size <= 0) {
+        append_message(error_message, message_len, "font_size must be positive; fallback to 28.");
+        config->font_size = 28;
+        valid = false;
+    }
+
+    if (config->refresh_interval_seconds < 0) {
+        append_message(error_message, message_len, "refresh_interval_seconds must be non-negative; using 0.");
+        config->refresh_interval_seconds = DEFAULT_REFRESH_INTERVAL_SECONDS;
+        valid = false;
+    }
+
+    if (config->texture_cache_mb < 0) {
+        append_message(error_message, message_len, "texture_cache_mb must be non-negative; using default.");
+        config->texture_cache_mb = DEFAULT_TEXTURE_CACHE_MB;
+        valid = false;
+    }
+
+    if (config->frame_rate < 0) {
+        append_message(error_message, message_len, "frame_rate must be display, auto or positive; following the display.");
+        config->frame_rate = 0;
+        valid = false;
+    }
+
+    if (config->control_port < 0 || config->control_port > 65535) {
+        append_message(error_message, message_len, "control_port must be 0-65535; control endpoint disabled.");
+        config->control_port = 0;
+        valid = false;
+    }
+
+    if (config->texture_budget_mb < 0) {
+        append_message(error_message, message_len, "texture_budget_mb must be non-negative; leaving textures uncapped.");
+        config->texture_budget_mb = 0;
+        valid = false;
+    }
+
+    if (config->line_padding < 0) {
+        append_message(error_message, message_len, "line_padding must be non-negative; using default spacing.");
+        config->line_padding = DEFAULT_LINE_PADDING;
+        valid = false;
+    }
+
+    if (config->scroll_speed_min <= 0.0f) {
+        append_message(error_message, message_len, "scroll_speed_min must be positive; using defaults.");
+        config->scroll_speed_min = DEFAULT_SCROLL_SPEED_MIN;
+        config->scroll_speed_max = DEFAULT_SCROLL_SPEED_MAX;
+        valid = false;
+    }
+
+    if (config->scroll_speed_max <= config->scroll_speed_min) {
+        append_message(error_message, message_len, "scroll_speed_max must be greater than scroll_speed_min; using defaults.");
+        config->scroll_speed_min = DEFAULT_SCROLL_SPEED_MIN;
+        config->scroll_speed_max = DEFAULT_SCROLL_SPEED_MAX;
+        valid = false;
+    }
+
+    size_t code_len = strlen(config->country_code);
+    if (code_len != 2) {
+        append_message(error_message, message_len, "country_code must be a 2-letter ISO code.");
+        strcpy(config->country_code, "us");
+        valid = false;
+    }
+
+    FILE *font_check = fopen(config->font_path, "r");
+    if (!font_check) {
+        append_message(error_message, message_len, "Configured font not found; attempting system fallback.");
+        valid = false;
+    } else {
+        fclose(font_check);
+    }
+
+    fprintf(stdout, "Config loaded: Country='%s', Font='%s', Size=%d, Refresh=%ds\n", config->country_code, config->font_path, config->font_size, config->refresh_interval_seconds);
+
+    return valid;
+}
+
+// Accepts RRGGBB with an optional leading '#'
+static bool parse_hex_color(const char *text, SDL_Color *color) {
+    if (text[0] == '#') text++;
+    if (strlen(text) != 6) return false;
+    for (int i = 0; i < 6; ++i) {
+        if (!isxdigit((unsigned char)text[i])) return false;
+    }
+    unsigned long rgb = strtoul(text, NULL, 16);
+    *color = (SDL_Color){ (Uint8)(rgb >> 16), (Uint8)(rgb >> 8), (Uint8)rgb, 255 };
+    return true;
+}
+
+// Replaces the palette only if every entry parses, so a typo keeps the defaults rather than a partial list
+static bool parse_color_list(char *value, struct Config *config) {
+    SDL_Color colors[MAX_HEADLINE_COLORS];
+    int count = 0;
+    for (char *name = strtok(value, ","); name; name = strtok(NULL, ",")) {
+        trim_whitespace(name);
+        if (count == MAX_HEADLINE_COLORS || !parse_hex_color(name, &colors[count])) return false;
+        count++;
+    }
+    if (count == 0) return false;
+    memcpy(config->colors, colors, sizeof(colors[0]) * (size_t)count);
+    config->num_colors = count;
+    return true;
+}
+
+void watch_config_file(struct ConfigWatch *watch) {
+    struct stat info;
+    memset(watch, 0, sizeof(*watch));
+    if (stat(CONFIG_FILE, &info) == 0) {
+        watch->mtime = info.st_mtime;
+        watch->size = (long long)info.st_size;
+    }
+    watch->next_check = SDL_GetTicks() + CONFIG_POLL_MS;
+}
+
+// A stat() a second is cheaper than any notification API, and behaves the same on every platform and filesystem
+bool poll_config_file(struct ConfigWatch *watch) {
+    Uint32 now = SDL_GetTicks();
+    if (!SDL_TICKS_PASSED(now, watch->next_check)) return false;
+    watch->next_check = now + CONFIG_POLL_MS;
+    struct stat info;
+    // Editors that save by rename leave the file briefly missing; wait for it to come back
+    if (stat(CONFIG_FILE, &info) != 0) return false;
+    if (info.st_mtime == watch->mtime && (long long)info.st_size == watch->size) return false;
+    watch->mtime = info.st_mtime;
+    watch->size = (long long)info.st_size;
+    return true;
+}
+
+// Applies what can change without reopening windows or refetching, touching only what each setting affects.
+// Headlines keep their lanes and positions; network, display and logging settings wait for a restart.
+void apply_config_reload(struct Config *config, const struct Config *next, struct TickerWindow *windows, int window_count, struct HeadlineStore *store, struct Hud *hud, struct LineSnapshot *snapshot, struct FontChain *fonts, const char **font_file) {
+    const struct Config previous = *config;
+    struct Config deferred = *next;
+    memcpy(deferred.font_path, previous.font_path, sizeof(deferred.font_path));
+    memcpy(deferred.fallback_fonts, previous.fallback_fonts, sizeof(deferred.fallback_fonts));
+    deferred.font_size = previous.font_size;
+    deferred.line_padding = previous.line_padding;
+    deferred.scroll_speed_min = previous.scroll_speed_min;
+    deferred.scroll_speed_max = previous.scroll_speed_max;
+    deferred.background_color = previous.background_color;
+    memcpy(deferred.colors, previous.colors, sizeof(deferred.colors));
+    deferred.num_colors = previous.num_colors;
+    deferred.texture_cache_mb = previous.texture_cache_mb;
+    deferred.show_hud = previous.show_hud;
+    deferred.idle_when_static = previous.idle_when_static;
+    bool needs_restart = memcmp(&deferred, &previous, sizeof(previous)) != 0;
+
+    memcpy(config->font_path, next->font_path, sizeof(config->font_path));
+    memcpy(config->fallback_fonts, next->fallback_fonts, sizeof(config->fallback_fonts));
+    config->font_size = next->font_size;
+    config->line_padding = next->line_padding;
+    config->scroll_speed_min = next->scroll_speed_min;
+    config->scroll_speed_max = next->scroll_speed_max;
+    config->background_color = next->background_color;
+    memcpy(config->colors, next->colors, sizeof(config->colors));
+    config->num_colors = next->num_colors;
+    config->texture_cache_mb = next->texture_cache_mb;
+    config->idle_when_static = next->idle_when_static;
+    if (next->show_hud != previous.show_hud) {
+        config->show_hud = next->show_hud;
+        hud->visible = next->show_hud;
+        hud->next_update = 0;
+    }
+
+    bool font_changed = strcmp(config->font_path, previous.font_path) != 0 || config->font_size != previous.font_size ||
+                        strcmp(config->fallback_fonts, previous.fallback_fonts) != 0;
+    if (font_changed && !reload_font(config, &previous, windows, window_count, hud, snapshot, fonts, font_file)) {
+        font_changed = false;
+    }
+    bool layout_changed = font_changed || config->line_padding != previous.line_padding;
+    bool speed_changed = config->scroll_speed_min != previous.scroll_speed_min || config->scroll_speed_max != previous.scroll_speed_max;
+    bool colors_changed = config->num_colors != previous.num_colors || memcmp(config->colors, previous.colors, sizeof(config->colors)) != 0;
+
+    if (colors_changed) {
+        // Status lines keep their fixed colors; only palette-picked ones follow the palette
+        for (int i = 0; i < store->count; ++i) {
+            struct Headline *headline = &store->items[i];
+            if (!headline->text) continue;
+            SDL_Color old_color = headline_color(&previous, headline->text);
+            if (memcmp(&headline->color, &old_color, sizeof(SDL_Color)) == 0) {
+                headline->color = headline_color(config, headline->text);
+            }
+        }
+    }
+    for (int w = 0; w < window_count; ++w) {
+        struct TextRenderer *text_renderer = &windows[w].text_renderer;
+        if (!font_changed && config->texture_cache_mb != previous.texture_cache_mb) {
+            text_renderer->cache.budget_bytes = (size_t)config->texture_cache_mb * 1024 * 1024;
+            trim_texture_cache(&text_renderer->cache);
+        }
+        for (int p = 0; layout_changed && p < windows[w].pool_count; ++p) {
+            if (!relayout_lane_pool(&windows[w].pools[p], fonts->fonts[0], store, config)) {
+                fprintf(stderr, "Unable to re-space lanes; keeping the old layout.\n");
+            }
+        }
+    }
+    for (int w = 0; w < window_count; ++w) {
+        struct TextRenderer *text_renderer = &windows[w].text_renderer;
+        for (int p = 0; p < windows[w].pool_count; ++p) {
+            struct LanePool *pool = &windows[w].pools[p];
+            for (int i = 0; i < pool->count; ++i) {
+                struct NewsLine *line = &pool->lines[i];
+                if (!line->text) continue;
+                if (speed_changed) pool->speed[i] = random_speed(pool, config);
+                if (colors_changed) {
+                    SDL_Color color = line->headline >= 0 ? store->items[line->headline].color : headline_color(config, line->text);
+                    if (memcmp(&color, &line->color, sizeof(SDL_Color)) != 0) {
+                        line->color = color;
+                        release_line_pixels(line);
+                    }
+                }
+            }
+            fill_empty_lanes(pool, store, config);
+            refill_lanes(pool, store, text_renderer, 0.0f, config);
+        }
+    }
+    // The planned lines were keyed to the old font or colors and would never be captured
+    if ((font_changed || colors_changed) && !store->used_fallback) {
+        plan_line_snapshot(snapshot, windows, window_count, config->font_size);
+    }
+
+    fprintf(stdout, "Reloaded %s.%s\n", CONFIG_FILE, needs_restart ? " Network, display and logging changes apply after a restart." : "");
+}
+
+// Opens the new fonts before letting go of the old ones, so a bad path leaves the ticker as it was
+static bool reload_font(struct Config *config, const struct Config *previous, struct TickerWindow *windows, int window_count, struct Hud *hud, struct LineSnapshot *snapshot, struct FontChain *fonts, const char **font_file) {
+    const char *opened = NULL;
+    struct FontChain next_fonts;
+    if (!open_font_chain(&next_fonts, config, &opened)) {
+        memcpy(config->font_path, previous->font_path, sizeof(config->font_path));
+        memcpy(config->fallback_fonts, previous->fallback_fonts, sizeof(config->fallback_fonts));
+        config->font_size = previous->font_size;
+        return false;
+    }
+
+    // Every texture, atlas glyph and shaped run came from the old fonts; lanes rasterize again as refill_lanes reaches them
+    for (int w = 0; w < window_count; ++w) {
+        for (int p = 0; p < windows[w].pool_count; ++p) {
+            for (int i = 0; i < windows[w].pools[p].count; ++i) {
+                release_line_pixels(&windows[w].pools[p].lines[i]);
+            }
+        }
+        destroy_glyph_atlas(&windows[w].text_renderer.atlas);
+        destroy_texture_cache(&windows[w].text_renderer.cache);
+    }
+    close_line_snapshot(snapshot);
+    open_line_snapshot(snapshot, opened, next_fonts.fonts[0], config);
+    // Renderers point at *fonts, so the new chain moves into place rather than being re-pointed
+    close_font_chain(fonts);
+    *fonts = next_fonts;
+    for (int w = 0; w < window_count; ++w) {
+        struct TextRenderer *text_renderer = &windows[w].text_renderer;
+        bool had_snapshot = text_renderer->snapshot != NULL;
+        const struct TextureBudget budget = text_renderer->budget; // Every line texture is released, so only its limit and counters remain
+        init_text_renderer(text_renderer, windows[w].renderer, fonts, config);
+        text_renderer->budget = budget;
+        if (had_snapshot && text_renderer->mode != TEXT_RENDER_ATLAS) text_renderer->snapshot = snapshot;
+    }
+
+    if (hud->font) TTF_CloseFont(hud->font);
+    hud->font = TTF_OpenFont(opened, HUD_FONT_SIZE);
+    hud->next_update = 0;
+    *font_file = opened;
+    return true;
+}
+
+static size_t WriteMemoryCallback(void *contents, size_t size, size_t nmemb, void *userp) {
+    size_t realsize = size * nmemb;
+    struct MemoryStruct *mem = (struct MemoryStruct *)userp;
+    size_t needed = mem->size + realsize + 1;
+    if (needed > mem->capacity) {
+        // Doubling keeps total copying linear in the body size
+        size_t capacity = mem->capacity > 0 ? mem->capacity * 2 : RESPONSE_BUFFER_INITIAL;
+        while (capacity < needed) capacity *= 2;
+        if (!reserve_memory(mem, capacity)) {
+            fprintf(stderr, "not enough memory (realloc returned NULL)\n");
+            return 0;
+        }
+    }
+    memcpy(&(mem->memory[mem->size]), contents, realsize);
+    mem->size += realsize;
+    mem->memory[mem->size] = 0;
+    return realsize;
+}
+
+// Grows the buffer to hold at least capacity bytes; never shrinks and keeps existing contents
+static bool reserve_memory(struct MemoryStruct *mem, size_t capacity) {
+    if (capacity <= mem->capacity) return true;
+    char *ptr = realloc(mem->memory, capacity);
+    if (!ptr) return false;
+    mem->memory = ptr;
+    mem->capacity = capacity;
+    return true;
+}
+
+static void free_memory(struct MemoryStruct *mem) {
+    free(mem->memory);
+    mem->memory = NULL;
+    mem->size = 0;
+    mem->capacity = 0;
+}
+
+// Returns room for len bytes without committing them; pair with arena_commit once the real size is known
+char *arena_reserve(struct StringArena *arena, size_t len) {
+    struct ArenaBlock *block = arena->head;
+    if (!block || block->capacity - block->used < len) {
+        size_t capacity = len > ARENA_BLOCK_SIZE ? len : ARENA_BLOCK_SIZE;
+        block = malloc(sizeof(*block) + capacity);
+        if (!block) return NULL;
+        block->next = arena->head;
+        block->used = 0;
+        block->capacity = capacity;
+        arena->head = block;
+    }
+    return block->data + block->used;
+}
+
+void arena_commit(struct StringArena *arena, size_t len) {
+    if (arena->head) {
+        arena->head->used += len;
+    }
+}
+
+char *arena_strdup(struct StringArena *arena, const char *text) {
+    size_t len = strlen(text) + 1;
+    char *copy = arena_reserve(arena, len);
+    if (!copy) return NULL;
+    memcpy(copy, text, len);
+    arena_commit(arena, len);
+    return copy;
+}
+
+// Drops every string at once; the newest block is kept so the next set usually allocates nothing
+void arena_reset(struct StringArena *arena) {
+    struct ArenaBlock *block = arena->head;
+    if (!block) return;
+    struct ArenaBlock *older = block->next;
+    while (older) {
+        struct ArenaBlock *next = older->next;
+        free(older);
+        older = next;
+    }
+    block->next = NULL;
+    block->used = 0;
+}
+
+void arena_free(struct StringArena *arena) {
+    struct ArenaBlock *block = arena->head;
+    while (block) {
+        struct ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->head = NULL;
+}
+
+void release_news_line(struct NewsLine *line) {
+    if (!line) return;
+    release_line_pixels(line);
+    if (line->owns_text && line->text) {
+        free(line->text);
+    }
+    line->text = NULL;
+    line->owns_text = false;
+    line->headline = -1;
+    line->deferrals = 0;
+}
+
+// Keeps the text, so the lane rasterizes it again the next time refill_lanes sees it
+void release_line_pixels(struct NewsLine *line) {
+    if (line->cached) {
+        // The cache owns the texture; dropping the reference makes it evictable
+        line->cached->refs--;
+        line->cached = NULL;
+        line->texture = NULL;
+    }
+    if (line->texture) {
+        if (line->budget) line->budget->line_bytes -= (size_t)line->texture_width * (size_t)line->texture_height * 4;
+        SDL_DestroyTexture(line->texture);
+        line->texture = NULL;
+    }
+    if (line->tiles) release_line_tiles(line);
+    line->budget = NULL;
+    free(line->quads);
+    line->quads = NULL;
+    line->quad_count = 0;
+    line->texture_width = 0;
+    line->texture_height = 0;
+}
+
+void rng_seed(struct Rng *rng, Uint64 seed, Uint64 stream) {
+    rng->state = 0;
+    rng->increment = (stream << 1) | 1;
+    rng_next(rng);
+    rng->state += seed;
+    rng_next(rng);
+}
+
+Uint32 rng_next(struct Rng *rng) {
+    Uint64 old = rng->state;
+    rng->state = old * 6364136223846793005ULL + rng->increment;
+    Uint32 xorshifted = (Uint32)(((old >> 18) ^ old) >> 27);
+    Uint32 rot = (Uint32)(old >> 59);
+    return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+// Uniform in [0, 1); the top 24 bits are exactly representable as a float
+float rng_unit(struct Rng *rng) {
+    return (rng_next(rng) >> 8) * (1.0f / 16777216.0f);
+}
+
+// Uniform in [0, bound) by multiply-shift, avoiding modulo's division
+Uint32 rng_below(struct Rng *rng, Uint32 bound) {
+    return (Uint32)(((Uint64)rng_next(rng) * bound) >> 32);
+}
+
+bool init_lane_pool(struct LanePool *pool, TTF_Font *font, SDL_Rect area, Uint64 seed, int stream, const struct Config *config) {
+    memset(pool, 0, sizeof(*pool));
+    pool->area = area;
+    rng_seed(&pool->rng, seed, (Uint64)stream);
+    int padding = config->line_padding < 0 ? 0 : config->line_padding;
+    int height = TTF_FontHeight(font);
+    int usable = area.h - 2 * padding;
+    if (height <= 0 || usable < height) return true;
+
+    int count = (usable - height) / (height + padding) + 1;
+    pool->lines = calloc((size_t)count, sizeof(*pool->lines));
+    pool->motion = calloc((size_t)count * 4, sizeof(float));
+    pool->wrapped = calloc((size_t)count, sizeof(*pool->wrapped));
+    if (!pool->lines || !pool->motion || !pool->wrapped) {
+        destroy_lane_pool(pool);
+        return false;
+    }
+    pool->count = count;
+    pool->x = pool->motion;
+    pool->prev_x = pool->motion + count;
+    pool->speed = pool->motion + 2 * count;
+    pool->wrap_x = pool->motion + 3 * count;
+    for (int i = 0; i < count; ++i) {
+        pool->lines[i].headline = -1;
+        pool->lines[i].y_position = area.y + padding + i * (height + padding);
+        pool->wrap_x[i] = -FLT_MAX;
+    }
+    return true;
+}
+
+void destroy_lane_pool(struct LanePool *pool) {
+    for (int i = 0; pool->lines && i < pool->count; ++i) {
+        release_news_line(&pool->lines[i]);
+    }
+    free(pool->lines);
+    free(pool->motion);
+    free(pool->wrapped);
+    pool->lines = NULL;
+    pool->motion = NULL;
+    pool->wrapped = NULL;
+    pool->count = 0;
+}
+
+// Re-spaces the lanes for a new line height or padding; lanes that still fit keep their headline and position
+bool relayout_lane_pool(struct LanePool *pool, TTF_Font *font, struct HeadlineStore *store, const struct Config *config) {
+    struct LanePool next;
+    if (!init_lane_pool(&next, font, pool->area, 0, 0, config)) return false;
+    next.rng = pool->rng;
+    for (int i = 0; i < pool->count; ++i) {
+        struct NewsLine *line = &pool->lines[i];
+        if (i >= next.count) {
+            if (line->headline >= 0) store->items[line->headline].shown = false;
+            release_news_line(line);
+            continue;
+        }
+        int y_position = next.lines[i].y_position;
+        next.lines[i] = *line;
+        next.lines[i].y_position = y_position;
+        next.x[i] = pool->x[i];
+        next.prev_x[i] = pool->prev_x[i];
+        next.speed[i] = pool->speed[i];
+        next.wrap_x[i] = pool->wrap_x[i];
+        next.wrapped[i] = pool->wrapped[i];
+    }
+    // The lines moved to next, so only the arrays are freed
+    free(pool->lines);
+    free(pool->motion);
+    free(pool->wrapped);
+    *pool = next;
+    return true;
+}
+
+// An empty lane stands still and can never wrap, so the update loop needs no test for it
+static void release_lane(struct LanePool *pool, int lane) {
+    release_news_line(&pool->lines[lane]);
+    pool->x[lane] = 0.0f;
+    pool->prev_x[lane] = 0.0f;
+    pool->speed[lane] = 0.0f;
+    pool->wrap_x[lane] = -FLT_MAX;
+    pool->wrapped[lane] = 0;
+}
+
+// Rasterizes the lane's text once it is about to scroll into view
+static bool rasterize_news_line(struct TextRenderer *text_renderer, struct NewsLine *line) {
+    if (text_renderer->mode == TEXT_RENDER_ATLAS) {
+        if (!layout_atlas_text(text_renderer, line) && text_renderer->atlas.full) {
+            if (line->deferrals >= TEXTURE_DEFERRAL_LIMIT || line_exceeds_texture(text_renderer, line)) {
+                build_line_tiles(text_renderer, line);
+            } else {
+                render_line_texture(text_renderer, line);
+            }
+        }
+    } else if (text_renderer->mode == TEXT_RENDER_TILED || line->deferrals >= TEXTURE_DEFERRAL_LIMIT || line_exceeds_texture(text_renderer, line)) {
+        build_line_tiles(text_renderer, line);
+    } else if (text_renderer->cache.budget_bytes > 0) {
+        acquire_cached_texture(text_renderer, line);
+    } else {
+        render_line_texture(text_renderer, line);
+    }
+    if (!news_line_has_content(line) && line->texture_width > 0) {
+        // The text rendered but the texture didn't fit in video memory
+        text_renderer->budget.failures++;
+        line->texture_width = 0;
+        line->texture_height = 0;
+        return false;
+    }
+    account_line_texture(text_renderer, line);
+    return news_line_has_content(line) && line->texture_height > 0;
+}
+
+static void spawn_news_line(struct LanePool *pool, int lane, const struct Config *config) {
+    float speed = random_speed(pool, config);
+    pool->x[lane] = (float)(pool->area.w + (int)rng_below(&pool->rng, 500));
+    pool->prev_x[lane] = pool->x[lane];
+    pool->wrapped[lane] = 0;
+    pool->speed[lane] = speed;
+}
+
+static float random_speed(struct LanePool *pool, const struct Config *config) {
+    float random_factor = rng_unit(&pool->rng);
+    float min_speed = config->scroll_speed_min;
+    float max_speed = config->scroll_speed_max;
+    if (max_speed <= min_speed) {
+        min_speed = DEFAULT_SCROLL_SPEED_MIN;
+        max_speed = DEFAULT_SCROLL_SPEED_MAX;
+    }
+    return min_speed + (max_speed - min_speed) * random_factor;
+}
+
+// The lane keeps its own copy of the text so it can outlive the store it was taken from
+static bool assign_lane(struct LanePool *pool, int lane, struct HeadlineStore *store, int index, const struct Config *config) {
+    release_lane(pool, lane);
+    struct NewsLine *line = &pool->lines[lane];
+    struct Headline *headline = &store->items[index];
+    size_t len = strlen(headline->text) + 1;
+    line->text = malloc(len);
+    if (!line->text) return false;
+    memcpy(line->text, headline->text, len);
+    line->owns_text = true;
+    line->color = headline->color;
+    line->headline = index;
+    headline->shown = true;
+    spawn_news_line(pool, lane, config);
+    return true;
+}
+
+// Round-robin from the cursor, so every headline gets a turn however few lanes fit
+static int next_free_headline(struct HeadlineStore *store) {
+    // Injected stories jump the rotation in the order they came in
+    int first = -1;
+    for (int i = 0; i < store->count; ++i) {
+        const struct Headline *headline = &store->items[i];
+        if (headline->waiting && headline->text && !headline->shown && (first < 0 || headline->queued < store->items[first].queued)) first = i;
+    }
+    if (first >= 0) {
+        store->items[first].waiting = false;
+        return first;
+    }
+    for (int n = 0; n < store->count; ++n) {
+        int index = (store->cursor + n) % store->count;
+        const struct Headline *headline = &store->items[index];
+        if (headline->text && !headline->shown) {
+            store->cursor = (index + 1) % store->count;
+            return index;
+        }
+    }
+    return -1;
+}
+
+// Call once every pool is attached, so no pool hands out a headline another pool's lane is still showing
+void fill_empty_lanes(struct LanePool *pool, struct HeadlineStore *store, const struct Config *config) {
+    for (int i = 0; i < pool->count; ++i) {
+        if (pool->lines[i].text) continue;
+        int index = next_free_headline(store);
+        if (index < 0) return;
+        if (!assign_lane(pool, i, store, index, config)) release_lane(pool, i);
+    }
+}
+
+// Points the lanes at a freshly built store; unless restarting, a lane mid-scroll finishes its pass rather than jumping
+void attach_headline_store(struct LanePool *pool, struct HeadlineStore *store, bool restart) {
+    for (int i = 0; i < pool->count; ++i) {
+        struct NewsLine *line = &pool->lines[i];
+        if (restart) {
+            release_lane(pool, i);
+            continue;
+        }
+        line->headline = -1;
+        if (!line->text) continue;
+        // A reworded or re-sourced title is still the story this lane is showing, so the lane keeps its place and texture
+        int h = find_headline(store, headline_identity(line->text));
+        if (h >= 0 && !store->items[h].shown && store->items[h].text) {
+            store->items[h].shown = true;
+            line->headline = h;
+        }
+    }
+}
+
+// Hands wrapped lanes their next headline and rasterizes whatever is about to come on screen
+void refill_lanes(struct LanePool *pool, struct HeadlineStore *store, struct TextRenderer *text_renderer, float lookahead, const struct Config *config) {
+    const float raster_edge = (float)pool->area.w + lookahead;
+    bool released = false;
+    recover_texture_limit(&text_renderer->budget);
+    for (int i = 0; i < pool->count; ++i) {
+        struct NewsLine *line = &pool->lines[i];
+        if (pool->wrapped[i]) {
+            if (line->headline >= 0) store->items[line->headline].shown = false;
+            int index = next_free_headline(store);
+            if (index < 0) {
+                release_lane(pool, i);
+                released = true;
+                continue;
+            }
+            if (index == line->headline) {
+                // Only headline left for this lane; its texture is still good
+                store->items[index].shown = true;
+                spawn_news_line(pool, i, config);
+            } else if (!assign_lane(pool, i, store, index, config)) {
+                release_lane(pool, i);
+                released = true;
+                continue;
+            }
+        }
+        if (line->text && !news_line_has_content(line) && pool->x[i] <= raster_edge) {
+            struct TextureBudget *budget = &text_renderer->budget;
+            int failures = budget->failures;
+            size_t bytes = estimate_line_bytes(text_renderer, line);
+            if (budget->limit_bytes > 0 && bytes > budget->limit_bytes && line->deferrals < TEXTURE_DEFERRAL_LIMIT) {
+                // No amount of waiting frees enough for it in one piece; tiled, it needs a tile at a time
+                line->deferrals = TEXTURE_DEFERRAL_LIMIT;
+                bytes = estimate_line_bytes(text_renderer, line);
+            }
+            if (budget->limit_bytes > 0 && bytes > budget->limit_bytes) {
+                // Too big even tiled; the lane moves on rather than holding its place for good
+                if (line->headline >= 0) drop_headline_text(store, line->headline);
+                release_lane(pool, i);
+                released = true;
+            } else if (!make_texture_room(text_renderer, pool, bytes, raster_edge)) {
+                // Waits just off screen for a line ahead of it to scroll away and free its texture
+                if (line->deferrals == 0) budget->deferrals++;
+                if (line->deferrals < TEXTURE_DEFERRAL_LIMIT) line->deferrals++;
+                if (pool->x[i] < (float)pool->area.w) pool->x[i] = pool->prev_x[i] = (float)pool->area.w;
+            } else if (rasterize_news_line(text_renderer, line)) {
+                pool->wrap_x[i] = -(float)line->texture_width;
+            } else if (budget->failures != failures) {
+                // Allocation failed below the configured budget, so the real limit is what is held now
+                size_t in_use = texture_bytes_in_use(text_renderer);
+                if (in_use > 0 && (budget->limit_bytes == 0 || in_use < budget->limit_bytes)) {
+                    budget->limit_bytes = in_use;
+                    budget->capped_at = SDL_GetTicks();
+                    fprintf(stderr, "Texture allocation failed; capping textures at %.1f MB.\n", in_use / (1024.0 * 1024.0));
+                }
+                if (pool->x[i] < (float)pool->area.w) pool->x[i] = pool->prev_x[i] = (float)pool->area.w;
+            } else {
+                // Drop it from the rotation rather than failing again on every pass
+                if (line->headline >= 0) drop_headline_text(store, line->headline);
+                release_lane(pool, i);
+                released = true;
+            }
+        }
+        if (line->tiles) stream_line_tiles(text_renderer, pool, i, raster_edge);
+    }
+    if (released) fill_empty_lanes(pool, store, config);
+}
+
+static bool store_add_headline(struct HeadlineStore *store, char *text, SDL_Color color) {
+    if (store->count == store->capacity) {
+        int capacity = store->capacity > 0 ? store->capacity * 2 : 64;
+        struct Headline *grown = realloc(store->items, sizeof(*grown) * (size_t)capacity);
+        if (!grown) return false;
+        store->items = grown;
+        store->capacity = capacity;
+    }
+    store->items[store->count] = (struct Headline){ text, color, false, headline_identity(text), false, false, 0 };
+    // Counted only once indexed, so on failure the store holds nothing of text and the caller still owns it
+    if (!index_headline(store, store->count)) return false;
+    store->count++;
+    return true;
+}
+
+// Adds a line from the control endpoint or push_source as the next one a lane picks up. A story already in the
+// set is dropped, or with repeat, dealt out again. Past max_headlines injected stories, the oldest one no lane
+// is showing makes way, so a ticker fed only by pushes holds a bounded set however long it runs.
+static bool inject_headline(struct HeadlineStore *store, struct FontChain *fonts, const char *text, bool repeat, const struct Config *config) {
+    char headline[CONTROL_BODY_MAX + 1];
+    if (strlen(text) >= sizeof(headline)) return false;
+    size_t len = sanitize_headline_to(text, headline);
+    if (len == 0 || !drop_missing_glyphs(fonts, headline)) return false;
+    int index = find_headline(store, headline_identity(headline));
+    // A story taken out of the rotation keeps its place in the index; it comes back as a new one in that slot
+    bool dropped = index >= 0 && !store->items[index].text;
+    if (index >= 0 && !dropped && !repeat) return false;
+
+    if (index < 0 || dropped) {
+        char *copy = malloc(strlen(headline) + 1);
+        if (!copy) return false;
+        strcpy(copy, headline);
+        int retired = store->injected >= config->max_headlines ? oldest_injected_headline(store) : -1;
+        if (dropped) {
+            if (retired >= 0) drop_headline_text(store, retired);
+            store->items[index] = (struct Headline){ copy, headline_color(config, copy), false, headline_identity(copy), false, false, 0 };
+        } else if (retired >= 0) {
+            drop_headline_text(store, retired);
+            store->items[retired] = (struct Headline){ copy, headline_color(config, copy), false, headline_identity(copy), false, false, 0 };
+            reindex_headlines(store);
+            index = retired;
+        } else if (store_add_headline(store, copy, headline_color(config, copy))) {
+            index = store->count - 1;
+        } else {
+            free(copy);
+            return false;
+        }
+        store->items[index].injected = true;
+        store->injected++;
+    }
+
+    struct Headline *added = &store->items[index];
+    added->waiting = true;
+    added->queued = ++store->queue_clock;
+    fprintf(stdout, "Injected headline: %s\n", added->text);
+    return true;
+}
+
+// Injected story no lane is showing that came in first, or -1
+static int oldest_injected_headline(const struct HeadlineStore *store) {
+    int oldest = -1;
+    for (int i = 0; i < store->count; ++i) {
+        const struct Headline *headline = &store->items[i];
+        if (!headline->injected || !headline->text || headline->shown) continue;
+        if (oldest < 0 || headline->queued < store->items[oldest].queued) oldest = i;
+    }
+    return oldest;
+}
+
+// Takes a headline out of the rotation; lanes hold their own copies of the text
+static void drop_headline_text(struct HeadlineStore *store, int index) {
+    struct Headline *headline = &store->items[index];
+    if (headline->injected && headline->text) {
+        free(headline->text);
+        store->injected--;
+    }
+    headline->text = NULL;
+    headline->injected = false;
+    headline->waiting = false;
+}
+
+// Identifies the story rather than the exact text: case, spacing and punctuation are ignored, and so is a
+// trailing " - Publisher" attribution like the ones NewsAPI appends, so the same story from two feeds matches
+Uint64 headline_identity(const char *text) {
+    size_t len = strlen(text);
+    const char *suffix = NULL;
+    for (const char *dash = strstr(text, " - "); dash; dash = strstr(dash + 1, " - ")) {
+        suffix = dash;
+    }
+    if (suffix && (size_t)(text + len - suffix) <= HEADLINE_SOURCE_SUFFIX_MAX && (size_t)(suffix - text) >= len / 2) {
+        len = (size_t)(suffix - text);
+    }
+    Uint64 hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < len; ++i) {
+        unsigned char c = (unsigned char)text[i];
+        if (c < 0x80) {
+            if (!isalnum(c)) continue;
+            c = (unsigned char)tolower(c);
+        }
+        hash = (hash ^ c) * FNV_PRIME;
+    }
+    return hash;
+}
+
+// Index of the headline telling that story, or -1. Identities are 64-bit hashes; a collision would only
+// merge two stories, so texts are not compared.
+static int find_headline(const struct HeadlineStore *store, Uint64 identity) {
+    if (store->slot_capacity == 0) return -1;
+    const Uint32 mask = (Uint32)store->slot_capacity - 1;
+    for (Uint32 slot = (Uint32)identity & mask;; slot = (slot + 1) & mask) {
+        int entry = store->slots[slot];
+        if (entry == 0) return -1;
+        if (store->items[entry - 1].identity == identity) return entry - 1;
+    }
+}
+
+static bool headlines_unchanged(const struct HeadlineStore *current, const struct HeadlineStore *next) {
+    return !current->used_fallback && !next->used_fallback && current->count > 0 && next->diff.added == 0 && next->diff.removed == 0;
+}
+
+// Adds item index to the identity index, doubling and rehashing it past half full
+static bool index_headline(struct HeadlineStore *store, int index) {
+    if ((index + 1) * 2 > store->slot_capacity) {
+        int capacity = store->slot_capacity > 0 ? store->slot_capacity * 2 : 128;
+        int *slots = calloc((size_t)capacity, sizeof(*slots));
+        if (!slots) return false;
+        free(store->slots);
+        store->slots = slots;
+        store->slot_capacity = capacity;
+        for (int i = 0; i < index; ++i) {
+            index_headline(store, i);
+        }
+    }
+    const Uint32 mask = (Uint32)store->slot_capacity - 1;
+    Uint32 slot = (Uint32)store->items[index].identity & mask;
+    while (store->slots[slot] != 0) slot = (slot + 1) & mask;
+    store->slots[slot] = index + 1;
+    return true;
+}
+
+// After a slot is reused for another story; the index has no deletion, so it is rebuilt
+static void reindex_headlines(struct HeadlineStore *store) {
+    memset(store->slots, 0, sizeof(*store->slots) * (size_t)store->slot_capacity);
+    for (int i = 0; i < store->count; ++i) {
+        index_headline(store, i);
+    }
+}
+
+void reset_headline_store(struct HeadlineStore *store) {
+    for (int i = 0; i < store->count; ++i) {
+        if (store->items[i].injected) free(store->items[i].text);
+    }
+    store->injected = 0;
+    store->queue_clock = 0;
+    store->count = 0;
+    store->cursor = 0;
+    store->used_fallback = false;
+    memset(&store->diff, 0, sizeof(store->diff));
+    if (store->slots) memset(store->slots, 0, sizeof(*store->slots) * (size_t)store->slot_capacity);
+    arena_reset(&store->arena);
+}
+
+void free_headline_store(struct HeadlineStore *store) {
+    reset_headline_store(store);
+    free(store->items);
+    free(store->slots);
+    store->items = NULL;
+    store->slots = NULL;
+    store->slot_capacity = 0;
+    store->count = 0;
+    store->capacity = 0;
+    arena_free(&store->arena);
+}
+
+// Picks a palette color from the text itself so a headline keeps its color, and its cached texture, across refreshes
+SDL_Color headline_color(const struct Config *config, const char *text) {
+    if (config->num_colors <= 0) {
+        return config->colors[0];
+    }
+    Uint64 hash = texture_cache_key(text, (SDL_Color){0, 0, 0, 0}, 0);
+    return config->colors[(hash >> 32) % (Uint64)config->num_colors];
+}
+
+// Copies the previous set's injected and pushed stories into store, including those that came in over the
+// startup placeholder or the fallback lines; inject_headline already holds them to max_headlines
+static void carry_injected_headlines(struct HeadlineStore *store, const struct HeadlineStore *previous) {
+    if (!previous) return;
+    for (int i = 0; i < previous->count; ++i) {
+        const struct Headline *carried = &previous->items[i];
+        if (!carried->injected || !carried->text || find_headline(store, carried->identity) >= 0) continue;
+        char *copy = malloc(strlen(carried->text) + 1);
+        if (!copy) break;
+        strcpy(copy, carried->text);
+        if (!store_add_headline(store, copy, carried->color)) {
+            free(copy);
+            break;
+        }
+        struct Headline *added = &store->items[store->count - 1];
+        added->injected = true;
+        // Fallback lanes are all released when real headlines arrive, so these get dealt again first
+        added->waiting = carried->waiting || previous->used_fallback;
+        added->queued = carried->queued;
+        store->injected++;
+        if (carried->queued > store->queue_clock) store->queue_clock = carried->queued;
+        if (!previous->used_fallback) store->diff.kept++;
+    }
+}
+
+// Text-only: nothing is rasterized here, so a refresh costs the same for ten headlines or ten thousand
+int build_headline_store(struct Config *config, struct TextRenderer *text_renderer, struct HeadlineStore *store, const struct HeadlineStore *previous, struct HeadlineBatch *batch, const char *config_error_message, char *status_out, size_t status_len) {
+    if (!config || !text_renderer || !store || !batch) {
+        if (status_out && status_len > 0) {
+            snprintf(status_out, status_len, "Unable to rebuild headlines: invalid arguments.");
+        }
+        if (store) {
+            store->used_fallback = true;
+        }
+        return 0;
+    }
+
+    if (status_out && status_len > 0) {
+        status_out[0] = '\0';
+    }
+    reset_headline_store(store);
+
+    // The store adopts the batch's strings wholesale; its own emptied arena leaves with the batch
+    struct StringArena adopted = batch->arena;
+    batch->arena = store->arena;
+    store->arena = adopted;
+
+    int first_added = -1;
+    for (int i = 0; i < batch->count; ++i) {
+        char *headline = batch->titles[i];
+        if (!headline || !drop_missing_glyphs(text_renderer->fonts, headline)) continue;
+        // The same story twice in one set, from one feed or several, would hold two lanes at once
+        if (find_headline(store, headline_identity(headline)) >= 0) {
+            store->diff.duplicates++;
+            continue;
+        }
+        if (!store_add_headline(store, headline, headline_color(config, headline))) break;
+        const struct Headline *added = &store->items[store->count - 1];
+        bool known = previous && !previous->used_fallback && find_headline(previous, added->identity) >= 0;
+        if (known) {
+            store->diff.kept++;
+        } else {
+            store->diff.added++;
+            if (first_added < 0) first_added = store->count - 1;
+        }
+    }
+    // Injected and pushed stories outlive the poll that follows them
+    if (store->count > 0) carry_injected_headlines(store, previous);
+    if (store->count > 0) {
+        store->diff.removed = previous && !previous->used_fallback ? previous->count - store->diff.kept : 0;
+        // Stories kept from the last set are on screen or were recently; new ones take the next free lanes
+        if (first_added >= 0) store->cursor = first_added;
+        if (status_out && status_len > 0) {
+            snprintf(status_out, status_len, "Fetched %d headlines from %d source%s (%d new, %d gone, %d duplicates dropped).", store->count, batch->sources,
+                     batch->sources == 1 ? "" : "s", store->diff.added, store->diff.removed, store->diff.duplicates);
+        }
+        return store->count;
+    }
+
+    const char *fetch_error = batch->error;
+    store->used_fallback = true;
+
+    if (fetch_error[0]) {
+        fprintf(stderr, "%s\n", fetch_error);
+    }
+    fprintf(stderr, "Using fallback headlines.\n");
+
+    if (config_error_message && config_error_message[0] != '\0') {
+        char *error_line = arena_strdup(&store->arena, config_error_message);
+        if (error_line) {
+            store_add_headline(store, error_line, (SDL_Color){255, 80, 80, 255});
+        }
+    }
+
+    if (fetch_error[0]) {
+        size_t len = strlen(fetch_error) + 32;
+        char *status_line = arena_reserve(&store->arena, len);
+        if (status_line) {
+            int written = snprintf(status_line, len, "Falling back: %s", fetch_error);
+            arena_commit(&store->arena, (size_t)written + 1);
+            store_add_headline(store, status_line, (SDL_Color){255, 160, 0, 255});
+        }
+    }
+
+    for (int i = 0; fallback_news[i] != NULL; ++i) {
+        char *fallback_copy = arena_strdup(&store->arena, fallback_news[i]);
+        if (!fallback_copy) {
+            continue;
+        }
+        store_add_headline(store, fallback_copy, headline_color(config, fallback_copy));
+    }
+    carry_injected_headlines(store, previous);
+
+    if (status_out && status_len > 0) {
+        if (fetch_error[0]) {
+            snprintf(status_out, status_len, "Fallback headlines (%s).", fetch_error);
+        } else if (config_error_message && config_error_message[0] != '\0') {
+            snprintf(status_out, status_len, "Fallback headlines (configuration issue).");
+        } else {
+            snprintf(status_out, status_len, "Fallback headlines loaded.");
+        }
+    }
+
+    return store->count;
+}
+
+static void newsapi_url(const struct Config *config, char *url, size_t url_len) {
+    int page_size = config->max_headlines < NEWSAPI_PAGE_MAX ? config->max_headlines : NEWSAPI_PAGE_MAX;
+    snprintf(url, url_len, "https://newsapi.org/v2/top-headlines?country=%s&pageSize=%d&apiKey=%s", config->country_code, page_size, config->api_key);
+}
+
+static void guardian_url(const struct Config *config, char *url, size_t url_len) {
+    int page_size = config->max_headlines < GUARDIAN_PAGE_MAX ? config->max_headlines : GUARDIAN_PAGE_MAX;
+    snprintf(url, url_len, "https://content.guardianapis.com/search?q=%s&page-size=%d&api-key=%s", config->guardian_query, page_size, config->guardian_api_key);
+}
+
+// Extracts sanitized titles from a complete feed body into batch; returns the number kept
+static int parse_feed_body(struct FeedSource *source, const char *body, size_t len, struct HeadlineBatch *batch) {
+    begin_feed_scan(source, batch);
+    if (source->format == FEED_FORMAT_RSS) {
+        rss_scanner_feed(&source->receiver.rss, body, len);
+    } else {
+        json_scanner_feed(&source->receiver.scanner, body, len);
+    }
+    return finish_feed_scan(source, batch);
+}
+
+// Points the source's receiver at batch and resets the scanner for its format
+static void begin_feed_scan(struct FeedSource *source, struct HeadlineBatch *batch) {
+    struct FeedReceiver *receiver = &source->receiver;
+    clear_batch_titles(batch);
+    batch->error[0] = '\0';
+    receiver->format = source->format;
+    receiver->body = &source->response;
+    memset(&receiver->received, 0, sizeof(receiver->received));
+    receiver->parse_ticks = 0;
+    if (source->format == FEED_FORMAT_RSS) {
+        rss_scanner_init(&receiver->rss, collect_batch_title, batch);
+    } else {
+        json_scanner_init(&receiver->scanner, source->schema, collect_batch_title, batch);
+    }
+}
+
+// Titles arrive mid-stream, before status is known; finish_feed_scan discards them if it isn't ok
+static void collect_batch_title(void *ctx, const char *title) {
+    struct HeadlineBatch *batch = (struct HeadlineBatch *)ctx;
+    if (batch->limit > 0 && batch->count >= batch->limit) return;
+
+    // Sanitize straight into the arena, leaving room for the trailing separator space
+    char *headline = arena_reserve(&batch->arena, strlen(title) + 2);
+    if (!headline) {
+        snprintf(batch->error, sizeof(batch->error), "Out of memory building headline.");
+        return;
+    }
+    size_t len = sanitize_headline_to(title, headline);
+    if (len == 0) return;
+    headline[len] = ' ';
+    headline[len + 1] = '\0';
+    if (!batch_add_title(batch, headline)) {
+        snprintf(batch->error, sizeof(batch->error), "Out of memory building headline.");
+        return;
+    }
+    arena_commit(&batch->arena, len + 2);
+}
+
+static bool batch_add_title(struct HeadlineBatch *batch, char *title) {
+    if (batch->count == batch->capacity) {
+        int capacity = batch->capacity > 0 ? batch->capacity * 2 : 32;
+        char **grown = realloc(batch->titles, sizeof(*grown) * (size_t)capacity);
+        if (!grown) return false;
+        batch->titles = grown;
+        batch->capacity = capacity;
     }
+    batch->titles[batch->count++] = title;
+    return true;
+}
 
-    if (config->font_size <= 0) {
-        append_message(error_message, message_len, "font_size must be positive; fallback to 28.");
-        config->font_size = 28;
-        valid = false;
+static int finish_feed_scan(struct FeedSource *source, struct HeadlineBatch *batch) {
+    struct FeedReceiver *receiver = &source->receiver;
+    bool rss = receiver->format == FEED_FORMAT_RSS;
+    bool complete = rss ? rss_scanner_finish(&receiver->rss) : json_scanner_finish(&receiver->scanner);
+    if (!complete) {
+        snprintf(batch->error, sizeof(batch->error), "%s returned invalid %s.", source->name, rss ? "XML" : "JSON");
+        clear_batch_titles(batch);
+        return 0;
+    }
+    if (!rss && !receiver->scanner.status_ok) {
+        snprintf(batch->error, sizeof(batch->error), "%s error: status != %s.", source->name, source->schema->status_ok);
+        clear_batch_titles(batch);
+        return 0;
+    }
+    if (batch->count > 0) {
+        batch->error[0] = '\0';
+    } else if (!batch->error[0]) {
+        snprintf(batch->error, sizeof(batch->error), "%s returned no headlines.", source->name);
     }
+    return batch->count;
+}
 
-    if (config->refresh_interval_seconds < 0) {
-        append_message(error_message, message_len, "refresh_interval_seconds must be non-negative; using 0.");
-        config->refresh_interval_seconds = DEFAULT_REFRESH_INTERVAL_SECONDS;
-        valid = false;
+static void clear_batch_titles(struct HeadlineBatch *batch) {
+    batch->count = 0;
+    arena_reset(&batch->arena);
+}
+
+static void release_batch_storage(struct HeadlineBatch *batch) {
+    arena_free(&batch->arena);
+    free(batch->titles);
+    batch->titles = NULL;
+    batch->count = 0;
+    batch->capacity = 0;
+}
+
+// Buffers the body for the response cache while the scanner picks titles out of the same bytes
+static size_t FeedWriteCallback(void *contents, size_t size, size_t nmemb, void *userp) {
+    struct FeedReceiver *receiver = (struct FeedReceiver *)userp;
+    size_t realsize = WriteMemoryCallback(contents, size, nmemb, receiver->body);
+    if (realsize > 0) {
+        Uint64 parse_start = SDL_GetPerformanceCounter();
+        if (receiver->format == FEED_FORMAT_RSS) {
+            rss_scanner_feed(&receiver->rss, (const char *)contents, realsize);
+        } else {
+            json_scanner_feed(&receiver->scanner, (const char *)contents, realsize);
+        }
+        receiver->parse_ticks += SDL_GetPerformanceCounter() - parse_start;
     }
+    return realsize;
+}
 
-    if (config->line_padding < 0) {
-        append_message(error_message, message_len, "line_padding must be non-negative; using default spacing.");
-        config->line_padding = DEFAULT_LINE_PADDING;
-        valid = false;
+void json_scanner_init(struct JsonStreamScanner *scanner, const struct JsonFeedSchema *schema, void (*on_title)(void *ctx, const char *title), void *ctx) {
+    char *text = scanner->text;
+    size_t text_cap = scanner->text_cap;
+    memset(scanner, 0, sizeof(*scanner));
+    // The capture buffer survives re-initialization so retries don't reallocate it
+    scanner->text = text;
+    scanner->text_cap = text_cap;
+    scanner->schema = schema;
+    scanner->on_title = on_title;
+    scanner->ctx = ctx;
+}
+
+void json_scanner_free(struct JsonStreamScanner *scanner) {
+    free(scanner->text);
+    scanner->text = NULL;
+    scanner->text_cap = 0;
+}
+
+static size_t json_path_length(const char *const *path) {
+    size_t len = 0;
+    while (len < JSON_PATH_MAX && path[len]) len++;
+    return len;
+}
+
+// True when the open containers are objects reached through exactly the keys in path
+static bool json_path_matches(const struct JsonStreamScanner *scanner, const char *const *path, int length) {
+    if (length > JSON_KEY_DEPTH) return false;
+    for (int i = 0; i < length; ++i) {
+        if (scanner->containers[i] != '{' || strcmp(scanner->keys[i], path[i]) != 0) return false;
     }
+    return true;
+}
 
-    if (config->scroll_speed_min <= 0.0f) {
-        append_message(error_message, message_len, "scroll_speed_min must be positive; using defaults.");
-        config->scroll_speed_min = DEFAULT_SCROLL_SPEED_MIN;
-        config->scroll_speed_max = DEFAULT_SCROLL_SPEED_MAX;
-        valid = false;
+// Decides, before a string value is read, whether its bytes are worth keeping
+static enum JsonCapture json_value_capture(const struct JsonStreamScanner *scanner) {
+    const struct JsonFeedSchema *schema = scanner->schema;
+    int depth = scanner->depth;
+
+    int status_len = (int)json_path_length(schema->status_path);
+    if (status_len > 0 && depth == status_len && json_path_matches(scanner, schema->status_path, depth)) {
+        return JSON_CAPTURE_STATUS;
     }
 
-    if (config->scroll_speed_max <= config->scroll_speed_min) {
-        append_message(error_message, message_len, "scroll_speed_max must be greater than scroll_speed_min; using defaults.");
-        config->scroll_speed_min = DEFAULT_SCROLL_SPEED_MIN;
-        config->scroll_speed_max = DEFAULT_SCROLL_SPEED_MAX;
-        valid = false;
+    // items_path -> array -> article object -> title_key
+    int items_len = (int)json_path_length(schema->items_path);
+    if (depth == items_len + 2 && depth <= JSON_KEY_DEPTH
+        && scanner->containers[items_len] == '[' && scanner->containers[items_len + 1] == '{'
+        && json_path_matches(scanner, schema->items_path, items_len)
+        && strcmp(scanner->keys[items_len + 1], schema->title_key) == 0) {
+        return JSON_CAPTURE_TITLE;
+    }
+    return JSON_CAPTURE_NONE;
+}
+
+static void json_capture_bytes(struct JsonStreamScanner *scanner, const char *bytes, size_t len) {
+    if (scanner->text_len + len + 1 > JSON_CAPTURE_MAX) {
+        len = scanner->text_len + 1 < JSON_CAPTURE_MAX ? JSON_CAPTURE_MAX - scanner->text_len - 1 : 0;
+    }
+    if (len == 0) return;
+    if (scanner->text_len + len + 1 > scanner->text_cap) {
+        size_t cap = scanner->text_cap ? scanner->text_cap : 256;
+        while (cap < scanner->text_len + len + 1) cap *= 2;
+        char *grown = realloc(scanner->text, cap);
+        if (!grown) {
+            scanner->failed = true;
+            return;
+        }
+        scanner->text = grown;
+        scanner->text_cap = cap;
+    }
+    memcpy(scanner->text + scanner->text_len, bytes, len);
+    scanner->text_len += len;
+}
+
+static size_t encode_utf8(Uint32 cp, char *out) {
+    if (cp < 0x80) {
+        out[0] = (char)cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = (char)(0xC0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = (char)(0xE0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (cp >> 18));
+    out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+static void json_capture_codepoint(struct JsonStreamScanner *scanner, Uint32 cp) {
+    char utf8[4];
+    json_capture_bytes(scanner, utf8, encode_utf8(cp, utf8));
+}
+
+static void json_end_string(struct JsonStreamScanner *scanner) {
+    if (scanner->capture != JSON_CAPTURE_NONE && scanner->text) {
+        scanner->text[scanner->text_len] = '\0';
+    }
+    switch (scanner->capture) {
+        case JSON_CAPTURE_KEY:
+            if (scanner->depth > 0 && scanner->depth <= JSON_KEY_DEPTH) {
+                snprintf(scanner->keys[scanner->depth - 1], JSON_KEY_MAX, "%s", scanner->text ? scanner->text : "");
+            }
+            scanner->expecting_key = false;
+            break;
+        case JSON_CAPTURE_STATUS:
+            scanner->saw_status = true;
+            scanner->status_ok = scanner->text && strcmp(scanner->text, scanner->schema->status_ok) == 0;
+            break;
+        case JSON_CAPTURE_TITLE:
+            if (scanner->on_title && scanner->text) {
+                scanner->on_title(scanner->ctx, scanner->text);
+            }
+            break;
+        default:
+            break;
+    }
+    if (scanner->depth == 0) scanner->seen_value = true;
+    scanner->capture = JSON_CAPTURE_NONE;
+    scanner->text_len = 0;
+    scanner->lex = JSON_LEX_STRUCTURE;
+}
+
+static bool json_literal_char(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '-' || c == '+' || c == '.' || c == 'E';
+}
+
+static int json_hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Consumes one structural character; everything outside strings and literals lands here
+static void json_structure_char(struct JsonStreamScanner *scanner, char c) {
+    switch (c) {
+        case ' ': case '\t': case '\n': case '\r':
+            return;
+        case '{':
+        case '[':
+            if (scanner->depth >= JSON_MAX_DEPTH || scanner->expecting_key) {
+                scanner->failed = true;
+                return;
+            }
+            if (scanner->depth < JSON_KEY_DEPTH) {
+                scanner->keys[scanner->depth][0] = '\0';
+            }
+            scanner->containers[scanner->depth++] = c;
+            scanner->expecting_key = (c == '{');
+            return;
+        case '}':
+        case ']':
+            if (scanner->depth == 0 || scanner->containers[scanner->depth - 1] != (c == '}' ? '{' : '[')) {
+                scanner->failed = true;
+                return;
+            }
+            scanner->depth--;
+            scanner->expecting_key = false;
+            if (scanner->depth == 0) scanner->seen_value = true;
+            return;
+        case ':':
+            if (scanner->depth == 0 || scanner->containers[scanner->depth - 1] != '{') scanner->failed = true;
+            return;
+        case ',':
+            if (scanner->depth == 0) {
+                scanner->failed = true;
+                return;
+            }
+            scanner->expecting_key = scanner->containers[scanner->depth - 1] == '{';
+            return;
+        case '"':
+            scanner->lex = JSON_LEX_STRING;
+            scanner->text_len = 0;
+            scanner->capture = scanner->expecting_key ? JSON_CAPTURE_KEY : json_value_capture(scanner);
+            return;
+        default:
+            if (json_literal_char(c) && !scanner->expecting_key) {
+                scanner->lex = JSON_LEX_LITERAL;
+                return;
+            }
+            scanner->failed = true;
+            return;
+    }
+}
+
+bool json_scanner_feed(struct JsonStreamScanner *scanner, const char *data, size_t len) {
+    size_t i = 0;
+    while (i < len && !scanner->failed) {
+        switch (scanner->lex) {
+            case JSON_LEX_STRING: {
+                // Runs of plain string bytes are copied, or skipped, in one go
+                size_t run = i;
+                while (run < len && data[run] != '"' && data[run] != '\\') run++;
+                if (scanner->capture != JSON_CAPTURE_NONE && run > i) {
+                    json_capture_bytes(scanner, data + i, run - i);
+                }
+                i = run;
+                if (i == len) break;
+                if (data[i] == '"') {
+                    json_end_string(scanner);
+                } else {
+                    scanner->lex = JSON_LEX_ESCAPE;
+                }
+                i++;
+                break;
+            }
+            case JSON_LEX_ESCAPE: {
+                char c = data[i++];
+                scanner->lex = JSON_LEX_STRING;
+                if (scanner->capture == JSON_CAPTURE_NONE) break;
+                char out = 0;
+                switch (c) {
+                    case '"': out = '"'; break;
+                    case '\\': out = '\\'; break;
+                    case '/': out = '/'; break;
+                    case 'b': out = '\b'; break;
+                    case 'f': out = '\f'; break;
+                    case 'n': out = '\n'; break;
+                    case 'r': out = '\r'; break;
+                    case 't': out = '\t'; break;
+                    case 'u':
+                        scanner->lex = JSON_LEX_UNICODE;
+                        scanner->unicode = 0;
+                        scanner->unicode_digits = 0;
+                        break;
+                    default:
+                        scanner->failed = true;
+                        break;
+                }
+                if (out) json_capture_bytes(scanner, &out, 1);
+                break;
+            }
+            case JSON_LEX_UNICODE: {
+                int digit = json_hex_value(data[i++]);
+                if (digit < 0) {
+                    scanner->failed = true;
+                    break;
+                }
+                scanner->unicode = (scanner->unicode << 4) | (Uint32)digit;
+                if (++scanner->unicode_digits < 4) break;
+
+                scanner->lex = JSON_LEX_STRING;
+                Uint32 cp = scanner->unicode;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    scanner->high_surrogate = cp; // Wait for the low half
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF && scanner->high_surrogate) {
+                    json_capture_codepoint(scanner, 0x10000 + ((scanner->high_surrogate - 0xD800) << 10) + (cp - 0xDC00));
+                    scanner->high_surrogate = 0;
+                } else {
+                    scanner->high_surrogate = 0;
+                    json_capture_codepoint(scanner, cp);
+                }
+                break;
+            }
+            case JSON_LEX_LITERAL:
+                if (json_literal_char(data[i])) {
+                    i++;
+                    break;
+                }
+                scanner->lex = JSON_LEX_STRUCTURE;
+                if (scanner->depth == 0) scanner->seen_value = true;
+                break; // Re-dispatch the delimiter as structure
+            case JSON_LEX_STRUCTURE:
+            default:
+                json_structure_char(scanner, data[i++]);
+                break;
+        }
+    }
+    return !scanner->failed;
+}
+
+// True when the document was complete and well nested
+bool json_scanner_finish(struct JsonStreamScanner *scanner) {
+    if (scanner->lex == JSON_LEX_LITERAL && scanner->depth == 0) {
+        scanner->lex = JSON_LEX_STRUCTURE;
+        scanner->seen_value = true;
+    }
+    return !scanner->failed && scanner->depth == 0 && scanner->lex == JSON_LEX_STRUCTURE && scanner->seen_value;
+}
+
+void rss_scanner_init(struct RssStreamScanner *scanner, void (*on_title)(void *ctx, const char *title), void *ctx) {
+    memset(scanner, 0, sizeof(*scanner));
+    scanner->on_title = on_title;
+    scanner->ctx = ctx;
+}
+
+static void rss_capture_bytes(struct RssStreamScanner *scanner, const char *bytes, size_t len) {
+    if (!scanner->in_title) return;
+    size_t room = sizeof(scanner->text) - 1 - scanner->text_len;
+    if (len > room) len = room;
+    memcpy(scanner->text + scanner->text_len, bytes, len);
+    scanner->text_len += len;
+}
+
+static bool rss_name_is(const char *name, size_t len, const char *expected) {
+    return len == strlen(expected) && strncmp(name, expected, len) == 0;
+}
+
+// Applies one complete tag; namespaced names such as media:title deliberately don't match
+static void rss_end_tag(struct RssStreamScanner *scanner) {
+    scanner->tag[scanner->tag_len] = '\0';
+    scanner->lex = RSS_LEX_TEXT;
+    const char *tag = scanner->tag;
+    if (tag[0] == '?' || tag[0] == '!') return; // XML declaration, doctype
+
+    bool closing = tag[0] == '/';
+    if (closing) tag++;
+    size_t name_len = strcspn(tag, " \t\r\n/");
+    bool is_item = rss_name_is(tag, name_len, "item") || rss_name_is(tag, name_len, "entry");
+    bool is_title = rss_name_is(tag, name_len, "title");
+
+    if (closing) {
+        if (scanner->depth == 0) {
+            scanner->failed = true;
+            return;
+        }
+        if (is_title && scanner->in_title && scanner->depth == scanner->item_depth + 1) {
+            scanner->text[scanner->text_len] = '\0';
+            if (scanner->on_title) scanner->on_title(scanner->ctx, scanner->text);
+            scanner->in_title = false;
+            scanner->text_len = 0;
+        } else if (is_item && scanner->depth == scanner->item_depth) {
+            scanner->item_depth = 0;
+            scanner->in_title = false;
+        }
+        scanner->depth--;
+        return;
+    }
+
+    scanner->seen_element = true;
+    if (scanner->tag_len > 0 && scanner->tag[scanner->tag_len - 1] == '/') return; // Self-closing
+    scanner->depth++;
+    if (is_item && scanner->item_depth == 0) {
+        scanner->item_depth = scanner->depth;
+    } else if (is_title && scanner->item_depth > 0 && scanner->depth == scanner->item_depth + 1) {
+        scanner->in_title = true;
+        scanner->text_len = 0;
+    }
+}
+
+static void rss_end_entity(struct RssStreamScanner *scanner) {
+    scanner->entity[scanner->entity_len] = '\0';
+    scanner->lex = RSS_LEX_TEXT;
+    const char *name = scanner->entity;
+    char out[4];
+    size_t len = 0;
+    if (name[0] == '#') {
+        Uint32 cp = (Uint32)strtoul(name + 1 + (name[1] == 'x' || name[1] == 'X'), NULL, (name[1] == 'x' || name[1] == 'X') ? 16 : 10);
+        if (cp > 0 && cp <= 0x10FFFF) len = encode_utf8(cp, out);
+    } else if (strcmp(name, "amp") == 0) {
+        out[len++] = '&';
+    } else if (strcmp(name, "lt") == 0) {
+        out[len++] = '<';
+    } else if (strcmp(name, "gt") == 0) {
+        out[len++] = '>';
+    } else if (strcmp(name, "quot") == 0) {
+        out[len++] = '"';
+    } else if (strcmp(name, "apos") == 0) {
+        out[len++] = '\'';
+    } else if (strcmp(name, "nbsp") == 0) {
+        out[len++] = ' '; // HTML-minded feeds use it despite XML not defining it
+    }
+    rss_capture_bytes(scanner, out, len);
+}
+
+// Tracks the "]]>" or "-->" that ends a CDATA section or comment; returns true once it is complete
+static bool rss_match_terminator(struct RssStreamScanner *scanner, const char *terminator, char c, bool keep_text) {
+    if (c == terminator[scanner->terminator_match]) {
+        if (++scanner->terminator_match == 3) {
+            scanner->terminator_match = 0;
+            return true;
+        }
+        return false;
+    }
+    // Both terminators are a doubled character then '>', so a third repeat shifts the match by one
+    if (scanner->terminator_match == 2 && c == terminator[0]) {
+        if (keep_text) rss_capture_bytes(scanner, &c, 1);
+        return false;
+    }
+    if (keep_text) {
+        rss_capture_bytes(scanner, terminator, (size_t)scanner->terminator_match);
+    }
+    scanner->terminator_match = 0;
+    if (c == terminator[0]) {
+        scanner->terminator_match = 1;
+    } else if (keep_text) {
+        rss_capture_bytes(scanner, &c, 1);
+    }
+    return false;
+}
+
+bool rss_scanner_feed(struct RssStreamScanner *scanner, const char *data, size_t len) {
+    size_t i = 0;
+    while (i < len && !scanner->failed) {
+        char c = data[i];
+        switch (scanner->lex) {
+            case RSS_LEX_TEXT: {
+                size_t run = i;
+                while (run < len && data[run] != '<' && data[run] != '&') run++;
+                rss_capture_bytes(scanner, data + i, run - i);
+                i = run;
+                if (i == len) break;
+                if (data[i] == '<') {
+                    scanner->lex = RSS_LEX_TAG;
+                    scanner->tag_len = 0;
+                    scanner->quote = 0;
+                } else {
+                    scanner->lex = RSS_LEX_ENTITY;
+                    scanner->entity_len = 0;
+                }
+                i++;
+                break;
+            }
+            case RSS_LEX_TAG:
+                i++;
+                if (scanner->quote) {
+                    if (c == scanner->quote) scanner->quote = 0;
+                    break;
+                }
+                if (c == '>') {
+                    rss_end_tag(scanner);
+                    break;
+                }
+                if ((c == '"' || c == '\'') && scanner->tag_len > 0 && scanner->tag[0] != '!') {
+                    scanner->quote = c;
+                }
+                if (scanner->tag_len < RSS_TAG_MAX - 1) {
+                    scanner->tag[scanner->tag_len++] = c;
+                }
+                if (scanner->tag_len == 3 && memcmp(scanner->tag, "!--", 3) == 0) {
+                    scanner->lex = RSS_LEX_COMMENT;
+                    scanner->terminator_match = 0;
+                } else if (scanner->tag_len == 8 && memcmp(scanner->tag, "![CDATA[", 8) == 0) {
+                    scanner->lex = RSS_LEX_CDATA;
+                    scanner->terminator_match = 0;
+                }
+                break;
+            case RSS_LEX_ENTITY:
+                if (c == ';') {
+                    rss_end_entity(scanner);
+                    i++;
+                } else if (scanner->entity_len < RSS_ENTITY_MAX - 1 && (isalnum((unsigned char)c) || c == '#')) {
+                    scanner->entity[scanner->entity_len++] = c;
+                    i++;
+                } else {
+                    // A bare '&' in sloppy feeds; keep it literally and rescan the character as text
+                    rss_capture_bytes(scanner, "&", 1);
+                    rss_capture_bytes(scanner, scanner->entity, scanner->entity_len);
+                    scanner->lex = RSS_LEX_TEXT;
+                }
+                break;
+            case RSS_LEX_CDATA:
+                i++;
+                if (rss_match_terminator(scanner, "]]>", c, true)) scanner->lex = RSS_LEX_TEXT;
+                break;
+            case RSS_LEX_COMMENT:
+            default:
+                i++;
+                if (rss_match_terminator(scanner, "-->", c, false)) scanner->lex = RSS_LEX_TEXT;
+                break;
+        }
+    }
+    return !scanner->failed;
+}
+
+// True when the document ended outside any markup with every element closed
+bool rss_scanner_finish(struct RssStreamScanner *scanner) {
+    return !scanner->failed && scanner->lex == RSS_LEX_TEXT && scanner->depth == 0 && scanner->seen_element;
+}
+
+// One refresh pass: every enabled feed downloads in parallel, failed feeds are retried with backoff,
+// then the latest good titles of all feeds are merged into batch
+static int fetch_feed_sources(struct FetchWorker *worker, struct HeadlineBatch *batch) {
+    if (!worker || !batch) {
+        return 0;
+    }
+
+    char *fetch_error = batch->error;
+    size_t fetch_error_len = sizeof(batch->error);
+    fetch_error[0] = '\0';
+    batch->count = 0;
+    batch->not_modified = false;
+
+    if (worker->source_count == 0) {
+        snprintf(fetch_error, fetch_error_len, "No news sources configured.");
+        return 0;
+    }
+    if (!worker->multi) {
+        worker->multi = curl_multi_init();
+        if (!worker->multi) {
+            snprintf(fetch_error, fetch_error_len, "Unable to initialize network client.");
+            return 0;
+        }
+    }
+
+    for (int i = 0; i < worker->source_count; ++i) {
+        struct FeedSource *source = &worker->sources[i];
+        source->settled = false;
+        source->fresh = false;
+        memset(&source->timing, 0, sizeof(source->timing));
+        snprintf(source->timing.name, sizeof(source->timing.name), "%s", source->name);
+    }
+
+    for (int attempt = 0; attempt < MAX_FETCH_ATTEMPTS; ++attempt) {
+        int started = 0;
+        for (int i = 0; i < worker->source_count; ++i) {
+            struct FeedSource *source = &worker->sources[i];
+            if (!source->settled && start_feed_transfer(worker, source)) {
+                started++;
+            }
+        }
+        if (started > 0) {
+            run_feed_transfers(worker);
+        }
+
+        bool all_settled = true;
+        for (int i = 0; i < worker->source_count; ++i) {
+            if (!worker->sources[i].settled) all_settled = false;
+        }
+        if (all_settled) {
+            break;
+        }
+        // Only the feeds that failed are retried; the others keep what they just delivered
+        if (attempt < MAX_FETCH_ATTEMPTS - 1 && !fetch_worker_sleep(worker, 250 * (attempt + 1))) {
+            break;
+        }
+    }
+
+    bool changed = false;
+    for (int i = 0; i < worker->source_count; ++i) {
+        struct FeedSource *source = &worker->sources[i];
+        if (source->fresh) changed = true;
+        if (!source->settled && source->incoming.error[0]) {
+            fprintf(stderr, "%s\n", source->incoming.error);
+            append_message(fetch_error, fetch_error_len, source->incoming.error);
+        }
+        if (source->response.capacity > RESPONSE_BUFFER_KEEP) {
+            // An unusually large payload shouldn't pin its buffer for the life of the process
+            free_memory(&source->response);
+        }
+    }
+
+    int num_headlines = merge_feed_sources(worker, batch);
+    if (num_headlines > 0 && !changed) {
+        // Every feed answered 304 or kept its previous titles, so the merged set is what's on screen
+        batch->not_modified = true;
+    }
+    if (num_headlines > 0 && changed) {
+        fetch_error[0] = '\0';
+    }
+    return num_headlines;
+}
+
+static int configure_feed_sources(struct FetchWorker *worker) {
+    const struct Config *config = &worker->config;
+    const char *cache_base = config->response_cache_path;
+    worker->source_count = 0;
+
+    struct FeedSource *source;
+    if (config->source_newsapi) {
+        source = &worker->sources[worker->source_count++];
+        snprintf(source->name, sizeof(source->name), "NewsAPI");
+        source->format = FEED_FORMAT_JSON;
+        source->schema = &newsapi_schema;
+        newsapi_url(config, source->url, sizeof(source->url));
+        snprintf(source->cache_path, sizeof(source->cache_path), "%s", cache_base);
+    }
+    if (config->source_guardian) {
+        source = &worker->sources[worker->source_count++];
+        snprintf(source->name, sizeof(source->name), "Guardian");
+        source->format = FEED_FORMAT_JSON;
+        source->schema = &guardian_schema;
+        guardian_url(config, source->url, sizeof(source->url));
+        if (cache_base[0]) snprintf(source->cache_path, sizeof(source->cache_path), "%s.guardian", cache_base);
+    }
+    for (int i = 0; config->source_rss && i < config->num_rss_urls; ++i) {
+        source = &worker->sources[worker->source_count++];
+        snprintf(source->name, sizeof(source->name), "RSS feed %d", i + 1);
+        source->format = FEED_FORMAT_RSS;
+        snprintf(source->url, sizeof(source->url), "%s", config->rss_urls[i]);
+        if (cache_base[0]) snprintf(source->cache_path, sizeof(source->cache_path), "%s.rss%d", cache_base, i + 1);
+    }
+    for (int i = 0; i < worker->source_count; ++i) {
+        worker->sources[i].latest.limit = config->max_headlines;
+        worker->sources[i].incoming.limit = config->max_headlines;
+    }
+    return worker->source_count;
+}
+
+// Arms one source's easy handle for a conditional GET and attaches it to the multi handle
+static bool start_feed_transfer(struct FetchWorker *worker, struct FeedSource *source) {
+    struct HeadlineBatch *incoming = &source->incoming;
+    CURL *curl_handle = feed_source_handle(worker, source);
+    if (!curl_handle) {
+        snprintf(incoming->error, sizeof(incoming->error), "%s: unable to initialize network client.", source->name);
+        return false;
+    }
+
+    struct MemoryStruct *response = &source->response;
+    response->size = 0;
+    if (!reserve_memory(response, RESPONSE_BUFFER_INITIAL)) {
+        snprintf(incoming->error, sizeof(incoming->error), "%s: out of memory before requesting headlines.", source->name);
+        return false;
+    }
+    response->memory[0] = '\0';
+
+    // Revalidate against the cached copy so an unchanged feed costs a header exchange, not a download
+    curl_slist_free_all(source->request_headers);
+    source->request_headers = NULL;
+    char header_line[320];
+    if (source->validators.etag[0]) {
+        snprintf(header_line, sizeof(header_line), "If-None-Match: %s", source->validators.etag);
+        source->request_headers = curl_slist_append(source->request_headers, header_line);
+    }
+    if (source->validators.last_modified[0]) {
+        snprintf(header_line, sizeof(header_line), "If-Modified-Since: %s", source->validators.last_modified);
+        source->request_headers = curl_slist_append(source->request_headers, header_line);
+    }
+    curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, source->request_headers);
+
+    begin_feed_scan(source, incoming);
+    source->curl_error[0] = '\0';
+    fprintf(stdout, "Attempting to fetch news from: %s\n", source->url);
+    if (curl_multi_add_handle(worker->multi, curl_handle) != CURLM_OK) {
+        snprintf(incoming->error, sizeof(incoming->error), "%s: unable to start request.", source->name);
+        return false;
+    }
+    source->active = true;
+    return true;
+}
+
+// Drives all attached transfers until each completes; sources are finished as they come in
+static void run_feed_transfers(struct FetchWorker *worker) {
+    int running = 1;
+    while (running > 0) {
+        if (curl_multi_perform(worker->multi, &running) != CURLM_OK) {
+            break;
+        }
+
+        CURLMsg *message;
+        int queued = 0;
+        while ((message = curl_multi_info_read(worker->multi, &queued))) {
+            if (message->msg != CURLMSG_DONE) continue;
+            CURL *curl_handle = message->easy_handle;
+            CURLcode result = message->data.result;
+            char *owner = NULL;
+            curl_easy_getinfo(curl_handle, CURLINFO_PRIVATE, &owner);
+            curl_multi_remove_handle(worker->multi, curl_handle);
+            if (owner) {
+                complete_feed_transfer((struct FeedSource *)owner, result);
+            }
+        }
+
+        // The abort callback fails transfers on shutdown, so this loop exits promptly either way
+        if (running > 0) {
+            curl_multi_wait(worker->multi, NULL, 0, 100, NULL);
+        }
+    }
+
+    for (int i = 0; i < worker->source_count; ++i) {
+        struct FeedSource *source = &worker->sources[i];
+        if (source->active) {
+            curl_multi_remove_handle(worker->multi, source->curl);
+            source->active = false;
+        }
+    }
+}
+
+static void complete_feed_transfer(struct FeedSource *source, CURLcode result) {
+    struct HeadlineBatch *incoming = &source->incoming;
+    source->active = false;
+
+    long response_code = 0;
+    curl_easy_getinfo(source->curl, CURLINFO_RESPONSE_CODE, &response_code);
+    if (result != CURLE_OK) {
+        snprintf(incoming->error, sizeof(incoming->error), "%s request failed (%.200s)", source->name, source->curl_error[0] ? source->curl_error : curl_easy_strerror(result));
+        clear_batch_titles(incoming);
+    } else if (response_code == 304) {
+        source->settled = true;
+        clear_batch_titles(incoming);
+    } else if (finish_feed_scan(source, incoming) > 0) {
+        // The new titles take over; the old ones' arena is recycled for the next download
+        struct HeadlineBatch previous = source->latest;
+        source->latest = *incoming;
+        *incoming = previous;
+        clear_batch_titles(incoming);
+        incoming->error[0] = '\0';
+
+        source->validators = source->receiver.received;
+        save_response_cache(source, source->response.memory, source->response.size);
+        source->settled = true;
+        source->fresh = true;
+    }
+    record_source_timing(source, source->settled);
+}
+
+// Splits curl's cumulative timestamps into per-phase durations; reused connections report zero setup
+static void record_source_timing(struct FeedSource *source, bool ok) {
+    struct SourceTiming *timing = &source->timing;
+    CURL *curl_handle = source->curl;
+    double dns = 0, connect = 0, tls = 0, first_byte = 0, total = 0;
+#if LIBCURL_VERSION_NUM >= 0x073D00
+    curl_off_t value = 0;
+    if (curl_easy_getinfo(curl_handle, CURLINFO_NAMELOOKUP_TIME_T, &value) == CURLE_OK) dns = value / 1000.0;
+    if (curl_easy_getinfo(curl_handle, CURLINFO_CONNECT_TIME_T, &value) == CURLE_OK) connect = value / 1000.0;
+    if (curl_easy_getinfo(curl_handle, CURLINFO_APPCONNECT_TIME_T, &value) == CURLE_OK) tls = value / 1000.0;
+    if (curl_easy_getinfo(curl_handle, CURLINFO_STARTTRANSFER_TIME_T, &value) == CURLE_OK) first_byte = value / 1000.0;
+    if (curl_easy_getinfo(curl_handle, CURLINFO_TOTAL_TIME_T, &value) == CURLE_OK) total = value / 1000.0;
+#else
+    double seconds = 0;
+    if (curl_easy_getinfo(curl_handle, CURLINFO_NAMELOOKUP_TIME, &seconds) == CURLE_OK) dns = seconds * 1000.0;
+    if (curl_easy_getinfo(curl_handle, CURLINFO_CONNECT_TIME, &seconds) == CURLE_OK) connect = seconds * 1000.0;
+    if (curl_easy_getinfo(curl_handle, CURLINFO_APPCONNECT_TIME, &seconds) == CURLE_OK) tls = seconds * 1000.0;
+    if (curl_easy_getinfo(curl_handle, CURLINFO_STARTTRANSFER_TIME, &seconds) == CURLE_OK) first_byte = seconds * 1000.0;
+    if (curl_easy_getinfo(curl_handle, CURLINFO_TOTAL_TIME, &seconds) == CURLE_OK) total = seconds * 1000.0;
+#endif
+    double connected = connect > dns ? connect : dns;
+    double secured = tls > connected ? tls : connected; // APPCONNECT is zero over plain HTTP
+    timing->ok = ok;
+    curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE, &timing->http_code);
+    timing->dns_ms = dns;
+    timing->connect_ms = connected - dns;
+    timing->tls_ms = secured - connected;
+    timing->wait_ms = first_byte > secured ? first_byte - secured : 0.0;
+    timing->transfer_ms = total > first_byte ? total - first_byte : 0.0;
+    timing->parse_ms = ticks_to_ms(source->receiver.parse_ticks);
+    timing->bytes = source->response.size;
+}
+
+// Interleaves feeds round-robin so one prolific source can't take every line
+static int merge_feed_sources(struct FetchWorker *worker, struct HeadlineBatch *batch) {
+    clear_batch_titles(batch);
+    batch->sources = 0;
+    int limit = worker->config.max_headlines;
+    for (int round = 0; batch->count < limit; ++round) {
+        bool any = false;
+        for (int i = 0; i < worker->source_count && batch->count < limit; ++i) {
+            const struct HeadlineBatch *latest = &worker->sources[i].latest;
+            if (round >= latest->count) continue;
+            any = true;
+            if (round == 0) batch->sources++;
+            char *title = arena_strdup(&batch->arena, latest->titles[round]);
+            if (title && !batch_add_title(batch, title)) {
+                return batch->count;
+            }
+        }
+        if (!any) break;
+    }
+    return batch->count;
+}
+
+// Captures cache validators from response headers; curl calls this once per header line
+static size_t HeaderCallback(char *buffer, size_t size, size_t nitems, void *userp) {
+    size_t realsize = size * nitems;
+    struct FeedReceiver *receiver = (struct FeedReceiver *)userp;
+    struct ResponseValidators *validators = &receiver->received;
+
+    if (realsize > 15 && SDL_strncasecmp(buffer, "Content-Length:", 15) == 0) {
+        // Size the receive buffer once up front instead of growing it chunk by chunk
+        char length_text[32];
+        size_t value_len = realsize - 15 < sizeof(length_text) - 1 ? realsize - 15 : sizeof(length_text) - 1;
+        memcpy(length_text, buffer + 15, value_len);
+        length_text[value_len] = '\0';
+        unsigned long long length = strtoull(length_text, NULL, 10);
+        if (length > 0 && length <= RESPONSE_BUFFER_MAX_HINT) {
+            reserve_memory(receiver->body, receiver->body->size + (size_t)length + 1);
+        }
+        return realsize;
+    }
+
+    char *target = NULL;
+    size_t target_len = 0;
+    size_t name_len = 0;
+    if (realsize > 5 && SDL_strncasecmp(buffer, "ETag:", 5) == 0) {
+        target = validators->etag;
+        target_len = sizeof(validators->etag);
+        name_len = 5;
+    } else if (realsize > 14 && SDL_strncasecmp(buffer, "Last-Modified:", 14) == 0) {
+        target = validators->last_modified;
+        target_len = sizeof(validators->last_modified);
+        name_len = 14;
+    }
+    if (target) {
+        size_t value_len = realsize - name_len;
+        if (value_len >= target_len) value_len = target_len - 1;
+        memcpy(target, buffer + name_len, value_len);
+        target[value_len] = '\0';
+        trim_whitespace(target);
+    }
+    return realsize;
+}
+
+// Cache files are a small text header (format tag, URL hash, validators), a blank line, then the raw body
+static bool load_response_cache(struct FeedSource *source, struct MemoryStruct *body) {
+    const char *path = source->cache_path;
+    if (!path[0]) return false;
+
+    FILE *file = fopen(path, "rb");
+    if (!file) return false;
+
+    char expected_key[32];
+    snprintf(expected_key, sizeof(expected_key), "%016llx", (unsigned long long)hash_bytes(source->url, strlen(source->url), FNV_OFFSET_BASIS));
+
+    struct ResponseValidators validators = {0};
+    bool header_ok = false;
+    bool key_ok = false;
+    char line[512];
+    while (fgets(line, sizeof(line), file)) {
+        if (line[0] == '\n' || (line[0] == '\r' && line[1] == '\n')) {
+            break;
+        }
+        char *value = strchr(line, ' ');
+        if (!value) continue;
+        *value++ = '\0';
+        trim_whitespace(value);
+        if (strcmp(line, RESPONSE_CACHE_MAGIC) == 0) header_ok = strcmp(value, RESPONSE_CACHE_VERSION) == 0;
+        else if (strcmp(line, "url") == 0) key_ok = strcmp(value, expected_key) == 0;
+        else if (strcmp(line, "etag") == 0) snprintf(validators.etag, sizeof(validators.etag), "%s", value);
+        else if (strcmp(line, "last-modified") == 0) snprintf(validators.last_modified, sizeof(validators.last_modified), "%s", value);
+    }
+    // A cache written for another URL (country, query or key) would serve the wrong feed
+    if (!header_ok || !key_ok) {
+        fclose(file);
+        return false;
     }
 
-    size_t code_len = strlen(config->country_code);
-    if (code_len != 2) {
-        append_message(error_message, message_len, "country_code must be a 2-letter ISO code.");
-        strcpy(config->country_code, "us");
-        valid = false;
+    long start = ftell(file);
+    fseek(file, 0, SEEK_END);
+    long end = ftell(file);
+    fseek(file, start, SEEK_SET);
+    if (start < 0 || end <= start) {
+        fclose(file);
+        return false;
     }
 
-    FILE *font_check = fopen(config->font_path, "r");
-    if (!font_check) {
-        append_message(error_message, message_len, "Configured font not found; attempting system fallback.");
-        valid = false;
-    } else {
-        fclose(font_check);
+    size_t len = (size_t)(end - start);
+    if (!reserve_memory(body, len + 1)) {
+        fclose(file);
+        return false;
     }
+    body->size = fread(body->memory, 1, len, file);
+    body->memory[body->size] = '\0';
+    fclose(file);
 
-    fprintf(stdout, "Config loaded: Country='%s', Font='%s', Size=%d, Refresh=%ds\n", config->country_code, config->font_path, config->font_size, config->refresh_interval_seconds);
-
-    return valid;
+    source->validators = validators;
+    return body->size > 0;
 }
 
-static size_t WriteMemoryCallback(void *contents, size_t size, size_t nmemb, void *userp) {
-    size_t realsize = size * nmemb;
-    struct MemoryStruct *mem = (struct MemoryStruct *)userp;
-    char *ptr = realloc(mem->memory, mem->size + realsize + 1);
-    if (!ptr) {
-        fprintf(stderr, "not enough memory (realloc returned NULL)\n");
-        return 0;
+static void save_response_cache(const struct FeedSource *source, const char *body, size_t len) {
+    const char *path = source->cache_path;
+    if (!path[0] || !body || len == 0) return;
+
+    char temp_path[sizeof(source->cache_path) + 8];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+    FILE *file = fopen(temp_path, "wb");
+    if (!file) {
+        fprintf(stderr, "Unable to write response cache %s.\n", temp_path);
+        return;
+    }
+    fprintf(file, "%s %s\n", RESPONSE_CACHE_MAGIC, RESPONSE_CACHE_VERSION);
+    fprintf(file, "url %016llx\n", (unsigned long long)hash_bytes(source->url, strlen(source->url), FNV_OFFSET_BASIS));
+    fprintf(file, "etag %s\n", source->validators.etag);
+    fprintf(file, "last-modified %s\n", source->validators.last_modified);
+    fprintf(file, "\n");
+    bool ok = fwrite(body, 1, len, file) == len;
+    ok = fclose(file) == 0 && ok;
+    if (!ok) {
+        remove(temp_path);
+        return;
     }
-    mem->memory = ptr;
-    memcpy(&(mem->memory[mem->size]), contents, realsize);
-    mem->size += realsize;
-    mem->memory[mem->size] = 0;
-    return realsize;
-}
 
-char* sanitize_headline(const char *title) {
-    if (!title) return NULL;
-    size_t len = strlen(title);
-    if (len == 0) return NULL;
+    // Write-then-rename so a crash mid-write never leaves a truncated cache behind
+#ifdef _WIN32
+    remove(path);
+#endif
+    if (rename(temp_path, path) != 0) {
+        remove(temp_path);
+    }
+}
 
-    char *buffer = malloc(len + 1);
-    if (!buffer) return NULL;
+// Parses each feed's on-disk copy so the ticker has real headlines before the network answers
+static bool load_cached_headlines(struct FetchWorker *worker, struct HeadlineBatch *batch) {
+    for (int i = 0; i < worker->source_count; ++i) {
+        struct FeedSource *source = &worker->sources[i];
+        struct MemoryStruct *body = &source->response;
+        body->size = 0;
+        if (!load_response_cache(source, body)) {
+            continue;
+        }
+        if (parse_feed_body(source, body->memory, body->size, &source->latest) == 0) {
+            // Don't send validators for a body we can't use
+            memset(&source->validators, 0, sizeof(source->validators));
+        }
+    }
+    return merge_feed_sources(worker, batch) > 0;
+}
 
-    size_t out = 0;
-    bool last_was_space = false;
-    for (size_t i = 0; i < len;) {
-        unsigned char c = (unsigned char)title[i];
-        if (c == '\0') break;
+bool start_fetch_worker(struct FetchWorker *worker, const struct Config *config) {
+    if (!worker || !config) return false;
 
-        if (c < 0x80) {
-            char normalized = normalize_ascii_char(c);
-            if (normalized == '\0') {
-                ++i;
-                continue;
-            }
-            if (normalized == ' ') {
-                if (out == 0 || last_was_space) {
-                    ++i;
-                    continue;
-                }
-                buffer[out++] = ' ';
-                last_was_space = true;
-            } else {
-                buffer[out++] = normalized;
-                last_was_space = false;
-            }
-            ++i;
-        } else {
-            if (out > 0 && !last_was_space) {
-                buffer[out++] = ' ';
-                last_was_space = true;
-            }
-            size_t advance = utf8_sequence_length(c);
-            if (advance == 0) {
-                advance = 1;
-            }
-            i += advance;
-        }
+    memset(worker, 0, sizeof(*worker));
+    worker->config = *config;
+    worker->wake_event = SDL_RegisterEvents(1);
+    worker->lock = SDL_CreateMutex();
+    worker->wake = SDL_CreateCond();
+    if (!worker->lock || !worker->wake) {
+        stop_fetch_worker(worker);
+        return false;
     }
 
-    while (out > 0 && buffer[out - 1] == ' ') {
-        --out;
+    worker->thread = SDL_CreateThread(fetch_worker_main, "news-fetch", worker);
+    if (!worker->thread) {
+        stop_fetch_worker(worker);
+        return false;
     }
+    return true;
+}
+
+void stop_fetch_worker(struct FetchWorker *worker) {
+    if (!worker) return;
 
-    buffer[out] = '\0';
+    SDL_AtomicSet(&worker->shutdown, 1);
+    if (worker->lock && worker->wake) {
+        // The push thread may be waiting on the same condition
+        SDL_LockMutex(worker->lock);
+        SDL_CondBroadcast(worker->wake);
+        SDL_UnlockMutex(worker->lock);
+    }
+    if (worker->thread) {
+        SDL_WaitThread(worker->thread, NULL);
+        worker->thread = NULL;
+    }
 
-    return buffer;
+    free_headline_batch(take_headline_batch(worker));
+    free(take_refresh_metrics(worker));
+    if (worker->wake) {
+        SDL_DestroyCond(worker->wake);
+        worker->wake = NULL;
+    }
+    if (worker->lock) {
+        SDL_DestroyMutex(worker->lock);
+        worker->lock = NULL;
+    }
 }
 
-void release_news_line(struct NewsLine *line) {
-    if (!line) return;
-    if (line->texture) {
-        SDL_DestroyTexture(line->texture);
-        line->texture = NULL;
+static bool start_push_source(struct FetchWorker *worker) {
+    const char *source = worker->config.push_source;
+    if (!source[0]) return false;
+#ifdef _WIN32
+    if (strncmp(source, "http://", 7) != 0 && strncmp(source, "https://", 8) != 0) {
+        fprintf(stderr, "push_source must be an http(s) event stream on Windows; named pipes need a POSIX system.\n");
+        return false;
     }
-    if (line->owns_text && line->text) {
-        free(line->text);
+#endif
+    worker->push_thread = SDL_CreateThread(push_worker_main, "news-push", worker);
+    if (!worker->push_thread) {
+        fprintf(stderr, "Unable to start push thread: %s\n", SDL_GetError());
+        return false;
     }
-    line->text = NULL;
-    line->owns_text = false;
-    line->scroll_x = 0.0f;
-    line->scroll_speed = 0.0f;
-    line->texture_width = 0;
-    line->texture_height = 0;
-    line->y_position = 0;
+    return true;
 }
 
-void clear_news_lines(struct NewsLine *lines, int count) {
-    if (!lines) return;
-    for (int i = 0; i < count; ++i) {
-        release_news_line(&lines[i]);
+// Shutdown is already set; the pipe poll and the stream's progress callback both notice it within a second
+static void stop_push_source(struct FetchWorker *worker) {
+    if (!worker->push_thread) return;
+    SDL_WaitThread(worker->push_thread, NULL);
+    worker->push_thread = NULL;
+}
+
+static int push_worker_main(void *data) {
+    struct FetchWorker *worker = (struct FetchWorker *)data;
+    const char *source = worker->config.push_source;
+    const bool stream = strncmp(source, "http://", 7) == 0 || strncmp(source, "https://", 8) == 0;
+    struct PushReader reader = { .worker = worker, .events = stream };
+    Uint32 backoff = PUSH_RETRY_MIN_MS;
+    while (!SDL_AtomicGet(&worker->shutdown)) {
+        Uint32 started = SDL_GetTicks();
+        int received = reader.received;
+        if (!(stream ? read_push_stream(worker, &reader) : read_push_pipe(worker, &reader))) break;
+        if (SDL_AtomicGet(&worker->shutdown)) break;
+        // A stream that delivered or held up for a while was healthy; start the backoff over
+        if (reader.received != received || SDL_GetTicks() - started > PUSH_RETRY_MAX_MS) backoff = PUSH_RETRY_MIN_MS;
+        fprintf(stderr, "Push source %s closed; reconnecting in %u s.\n", source, (unsigned)(backoff / 1000));
+        if (!fetch_worker_sleep(worker, backoff)) break;
+        backoff = backoff * 2 > PUSH_RETRY_MAX_MS ? PUSH_RETRY_MAX_MS : backoff * 2;
+        // A partial line or event from the dropped connection is discarded
+        reader.line_len = 0;
+        reader.data_len = 0;
+        reader.has_data = false;
+        reader.other_event = false;
+        reader.after_cr = false;
     }
+    return 0;
 }
 
-bool init_news_line(struct NewsLine *line, SDL_Renderer *renderer, TTF_Font *font, char *text, bool owns_text, SDL_Color color, int screen_width, int screen_height, int *y_cursor, const struct Config *config) {
-    if (!line || !renderer || !font || !text || !y_cursor || !config) {
-        if (owns_text) free(text);
-        return false;
+// Holds one connection to an SSE endpoint until it drops; false only if it can never work
+static bool read_push_stream(struct FetchWorker *worker, struct PushReader *reader) {
+    CURL *curl_handle = curl_easy_init();
+    if (!curl_handle) return false;
+    struct curl_slist *headers = curl_slist_append(NULL, "Accept: text/event-stream");
+    headers = curl_slist_append(headers, "Cache-Control: no-cache");
+    if (reader->last_event_id[0]) {
+        char resume[160];
+        snprintf(resume, sizeof(resume), "Last-Event-ID: %s", reader->last_event_id);
+        headers = curl_slist_append(headers, resume);
     }
+    char curl_error[CURL_ERROR_SIZE] = {0};
+    curl_easy_setopt(curl_handle, CURLOPT_URL, worker->config.push_source);
+    curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, PushWriteCallback);
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, (void *)reader);
+    curl_easy_setopt(curl_handle, CURLOPT_USERAGENT, "news-ticker/1.0");
+    curl_easy_setopt(curl_handle, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl_handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl_handle, CURLOPT_FAILONERROR, 1L);
+    // The stream is meant to stay open, so only connecting is timed; a silent one is dropped and reopened
+    curl_easy_setopt(curl_handle, CURLOPT_CONNECTTIMEOUT_MS, (long)worker->config.source_timeout_ms);
+    curl_easy_setopt(curl_handle, CURLOPT_LOW_SPEED_LIMIT, 1L);
+    curl_easy_setopt(curl_handle, CURLOPT_LOW_SPEED_TIME, (long)PUSH_STALL_SECONDS);
+    curl_easy_setopt(curl_handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl_handle, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(curl_handle, CURLOPT_XFERINFOFUNCTION, fetch_abort_callback);
+    curl_easy_setopt(curl_handle, CURLOPT_XFERINFODATA, (void *)worker);
+    curl_easy_setopt(curl_handle, CURLOPT_ERRORBUFFER, curl_error);
 
-    release_news_line(line);
-    line->text = text;
-    line->owns_text = owns_text;
-    line->color = color;
+    CURLcode res = curl_easy_perform(curl_handle);
+    if (res != CURLE_OK && !SDL_AtomicGet(&worker->shutdown)) {
+        fprintf(stderr, "Push stream failed: %s\n", curl_error[0] ? curl_error : curl_easy_strerror(res));
+    }
+    curl_slist_free_all(headers);
+    curl_easy_cleanup(curl_handle);
+    return true;
+}
 
-    render_text(renderer, font, line);
-    if (!line->texture || line->texture_height == 0) {
-        release_news_line(line);
+#ifndef _WIN32
+// Reads lines from a FIFO, creating it if needed; writers may come and go
+static bool read_push_pipe(struct FetchWorker *worker, struct PushReader *reader) {
+    const char *path = worker->config.push_source;
+    if (mkfifo(path, 0600) != 0 && errno != EEXIST) {
+        fprintf(stderr, "Unable to create push pipe %s: %s\n", path, strerror(errno));
         return false;
     }
-
-    int padding = config->line_padding < 0 ? 0 : config->line_padding;
-    int max_y = screen_height - padding;
-    if (max_y < 0) {
-        max_y = 0;
+    struct stat info;
+    if (stat(path, &info) != 0 || !S_ISFIFO(info.st_mode)) {
+        fprintf(stderr, "push_source %s exists and is not a named pipe.\n", path);
+        return false;
     }
-    if (*y_cursor + line->texture_height > max_y) {
-        release_news_line(line);
+    int fd = open(path, O_RDONLY | O_NONBLOCK);
+    if (fd < 0) {
+        fprintf(stderr, "Unable to open push pipe %s: %s\n", path, strerror(errno));
         return false;
     }
+    // Holding a write end ourselves keeps the pipe from reading as closed whenever the last writer leaves
+    int keep_open = open(path, O_WRONLY | O_NONBLOCK);
+    fprintf(stdout, "Reading pushed headlines from %s.\n", path);
 
-    line->y_position = *y_cursor;
-    *y_cursor += line->texture_height + padding;
-    float random_factor = rand() / (float)RAND_MAX;
-    line->scroll_x = (float)(screen_width + (rand() % 500));
-    float min_speed = config->scroll_speed_min;
-    float max_speed = config->scroll_speed_max;
-    if (max_speed <= min_speed) {
-        min_speed = DEFAULT_SCROLL_SPEED_MIN;
-        max_speed = DEFAULT_SCROLL_SPEED_MAX;
+    char chunk[4096];
+    while (!SDL_AtomicGet(&worker->shutdown)) {
+        struct pollfd ready = { fd, POLLIN, 0 };
+        int status = poll(&ready, 1, PUSH_POLL_MS);
+        if (status < 0 && errno != EINTR) break;
+        if (status <= 0) continue;
+        ssize_t got = read(fd, chunk, sizeof(chunk));
+        if (got > 0) {
+            feed_push_bytes(reader, chunk, (size_t)got);
+        } else if (got == 0 || (errno != EAGAIN && errno != EINTR)) {
+            break;
+        }
     }
-    line->scroll_speed = min_speed + (max_speed - min_speed) * random_factor;
-
+    if (keep_open >= 0) close(keep_open);
+    close(fd);
     return true;
 }
+#else
+static bool read_push_pipe(struct FetchWorker *worker, struct PushReader *reader) {
+    (void)worker;
+    (void)reader;
+    return false; // Refused in start_push_source
+}
+#endif
 
-int rebuild_headlines(struct Config *config, SDL_Renderer *renderer, TTF_Font *font, struct NewsLine *news_lines, int screen_width, int screen_height, const char *config_error_message, char *status_out, size_t status_len, bool *used_fallback_out) {
-    if (!config || !renderer || !font || !news_lines) {
-        if (status_out && status_len > 0) {
-            snprintf(status_out, status_len, "Unable to rebuild headlines: invalid arguments.");
+static size_t PushWriteCallback(void *contents, size_t size, size_t nmemb, void *userp) {
+    struct PushReader *reader = (struct PushReader *)userp;
+    feed_push_bytes(reader, (const char *)contents, size * nmemb);
+    return size * nmemb;
+}
+
+// Lines end in \n, \r\n or \r; longer ones than a headline could use are truncated
+static void feed_push_bytes(struct PushReader *reader, const char *bytes, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        char c = bytes[i];
+        if (c == '\n' && reader->after_cr) {
+            reader->after_cr = false;
+            continue;
         }
-        if (used_fallback_out) {
-            *used_fallback_out = true;
+        reader->after_cr = c == '\r';
+        if (c == '\n' || c == '\r') {
+            reader->line[reader->line_len] = '\0';
+            end_push_line(reader);
+            reader->line_len = 0;
+        } else if (reader->line_len < CONTROL_BODY_MAX) {
+            reader->line[reader->line_len++] = c;
         }
-        return 0;
     }
+}
 
-    if (status_out && status_len > 0) {
-        status_out[0] = '\0';
+static void end_push_line(struct PushReader *reader) {
+    const char *line = reader->line;
+    if (!reader->events) {
+        if (line[0]) deliver_pushed_headline(reader, line);
+        return;
     }
-    if (used_fallback_out) {
-        *used_fallback_out = false;
+
+    // A blank line dispatches the event built up by the data lines before it
+    if (!line[0]) {
+        if (reader->has_data && !reader->other_event) {
+            reader->data[reader->data_len] = '\0';
+            deliver_pushed_headline(reader, reader->data);
+        }
+        reader->data_len = 0;
+        reader->has_data = false;
+        reader->other_event = false;
+        return;
     }
+    if (line[0] == ':') return; // Comment, usually a keepalive
 
-    clear_news_lines(news_lines, MAX_LINES);
+    const char *colon = strchr(line, ':');
+    size_t name_len = colon ? (size_t)(colon - line) : strlen(line);
+    const char *value = colon ? colon + 1 : "";
+    if (*value == ' ') ++value;
+    if (name_len == 4 && strncmp(line, "data", 4) == 0) {
+        size_t value_len = strlen(value);
+        if (reader->has_data && reader->data_len < CONTROL_BODY_MAX) reader->data[reader->data_len++] = ' ';
+        if (value_len > CONTROL_BODY_MAX - reader->data_len) value_len = CONTROL_BODY_MAX - reader->data_len;
+        memcpy(reader->data + reader->data_len, value, value_len);
+        reader->data_len += value_len;
+        reader->has_data = true;
+    } else if (name_len == 5 && strncmp(line, "event", 5) == 0) {
+        reader->other_event = strcmp(value, "message") != 0 && strcmp(value, "headline") != 0;
+    } else if (name_len == 2 && strncmp(line, "id", 2) == 0) {
+        snprintf(reader->last_event_id, sizeof(reader->last_event_id), "%s", value);
+    }
+}
 
-    int y_cursor = config->line_padding < 0 ? 0 : config->line_padding;
-    char fetch_error[STATUS_BUFFER] = {0};
-    int num_headlines = fetch_newsapi_headlines(config, renderer, font, news_lines, screen_width, screen_height, &y_cursor, fetch_error, sizeof(fetch_error));
-    if (num_headlines > 0) {
-        if (status_out && status_len > 0) {
-            snprintf(status_out, status_len, "Fetched %d headlines from NewsAPI.", num_headlines);
+// Payloads are the headline itself, or a JSON object carrying it in "title"
+static void deliver_pushed_headline(struct PushReader *reader, const char *payload) {
+    struct ControlCommand command = { .kind = CONTROL_INJECT };
+    if (payload[0] == '{') {
+        cJSON *root = cJSON_Parse(payload);
+        const cJSON *title = cJSON_GetObjectItemCaseSensitive(root, "title");
+        if (cJSON_IsString(title) && title->valuestring) {
+            snprintf(command.text, sizeof(command.text), "%s", title->valuestring);
         }
-        return num_headlines;
+        cJSON_Delete(root);
+        if (!command.text[0]) return;
+    } else {
+        snprintf(command.text, sizeof(command.text), "%s", payload);
     }
 
-    if (used_fallback_out) {
-        *used_fallback_out = true;
+    struct FetchWorker *worker = reader->worker;
+    // The render loop drains the ring every frame, so a full one clears quickly; waiting loses nothing
+    while (!push_control_command(&worker->pushed, &command)) {
+        if (SDL_AtomicGet(&worker->shutdown)) return;
+        SDL_Delay(10);
     }
+    reader->received++;
+    if (worker->wake_event != (Uint32)-1) {
+        SDL_Event wake;
+        SDL_zero(wake);
+        wake.type = worker->wake_event;
+        SDL_PushEvent(&wake);
+    }
+}
 
-    if (fetch_error[0]) {
-        fprintf(stderr, "%s\n", fetch_error);
+// Callable from any thread. A pass already running finishes first; the next one then starts at once.
+void request_refresh(struct FetchWorker *worker) {
+    if (!worker || !worker->lock || !worker->wake) return;
+    SDL_AtomicSet(&worker->refresh_requested, 1);
+    SDL_LockMutex(worker->lock);
+    SDL_CondBroadcast(worker->wake);
+    SDL_UnlockMutex(worker->lock);
+}
+
+struct HeadlineBatch *take_headline_batch(struct FetchWorker *worker) {
+    if (!worker) return NULL;
+    return (struct HeadlineBatch *)SDL_AtomicSetPtr(&worker->ready, NULL);
+}
+
+void free_headline_batch(struct HeadlineBatch *batch) {
+    if (!batch) return;
+    release_batch_storage(batch);
+    free(batch);
+}
+
+struct RefreshMetrics *take_refresh_metrics(struct FetchWorker *worker) {
+    if (!worker) return NULL;
+    return (struct RefreshMetrics *)SDL_AtomicSetPtr(&worker->metrics, NULL);
+}
+
+static void publish_refresh_metrics(struct FetchWorker *worker, double total_ms) {
+    struct RefreshMetrics *metrics = calloc(1, sizeof(*metrics));
+    if (!metrics) return;
+    metrics->source_count = worker->source_count;
+    for (int i = 0; i < worker->source_count; ++i) {
+        metrics->sources[i] = worker->sources[i].timing;
     }
-    fprintf(stderr, "Using fallback headlines.\n");
+    metrics->total_ms = total_ms;
+    free(SDL_AtomicSetPtr(&worker->metrics, metrics));
+}
 
-    y_cursor = config->line_padding < 0 ? 0 : config->line_padding;
-    num_headlines = 0;
+static int fetch_worker_main(void *data) {
+    struct FetchWorker *worker = (struct FetchWorker *)data;
+    Uint32 refresh_interval_ms = (Uint32)worker->config.refresh_interval_seconds * 1000;
+    configure_feed_sources(worker);
 
-    if (config_error_message && config_error_message[0] != '\0') {
-        size_t len = strlen(config_error_message) + 1;
-        char *error_line = malloc(len);
-        if (error_line) {
-            snprintf(error_line, len, "%s", config_error_message);
-            if (num_headlines < MAX_LINES && init_news_line(&news_lines[num_headlines], renderer, font, error_line, true, (SDL_Color){255, 80, 80, 255}, screen_width, screen_height, &y_cursor, config)) {
-                num_headlines++;
-            }
-        }
+    // Publish something to show before touching the network: the last good set, or else a
+    // placeholder that makes the render loop put up the fallback lines instead of a blank screen
+    struct HeadlineBatch *cached = calloc(1, sizeof(*cached));
+    if (cached && load_cached_headlines(worker, cached)) {
+        fprintf(stdout, "Loaded %d cached headlines from %d source%s.\n", cached->count, cached->sources, cached->sources == 1 ? "" : "s");
+        SDL_AtomicSetPtr(&worker->ready, cached);
+    } else if (cached) {
+        clear_batch_titles(cached);
+        snprintf(cached->error, sizeof(cached->error), "No cached headlines yet; fetching.");
+        SDL_AtomicSetPtr(&worker->ready, cached);
     }
 
-    if (fetch_error[0]) {
-        size_t len = strlen(fetch_error) + 32;
-        char *status_line = malloc(len);
-        if (status_line) {
-            snprintf(status_line, len, "Falling back: %s", fetch_error);
-            if (num_headlines < MAX_LINES && init_news_line(&news_lines[num_headlines], renderer, font, status_line, true, (SDL_Color){255, 160, 0, 255}, screen_width, screen_height, &y_cursor, config)) {
-                num_headlines++;
+    start_push_source(worker);
+
+    while (!SDL_AtomicGet(&worker->shutdown)) {
+        struct HeadlineBatch *batch = calloc(1, sizeof(*batch));
+        if (batch) {
+            Uint64 pass_start = SDL_GetPerformanceCounter();
+            fetch_feed_sources(worker, batch);
+            publish_refresh_metrics(worker, ticks_to_ms(SDL_GetPerformanceCounter() - pass_start));
+            if (batch->not_modified) {
+                fprintf(stdout, "Headlines unchanged since last fetch.\n");
+                free_headline_batch(batch);
+            } else {
+                // A batch the render loop never picked up is superseded by the newer one
+                free_headline_batch((struct HeadlineBatch *)SDL_AtomicSetPtr(&worker->ready, batch));
             }
         }
-    }
 
-    for (int i = 0; fallback_news[i] != NULL && i < MAX_LINES; ++i) {
-        if (num_headlines >= MAX_LINES) {
+        // Without an interval the worker only stays up if the control endpoint can ask it for a pass
+        if ((refresh_interval_ms == 0 && worker->config.control_port == 0) || !wait_for_refresh(worker, refresh_interval_ms)) {
             break;
         }
-        size_t len = strlen(fallback_news[i]) + 1;
-        char *fallback_copy = malloc(len);
-        if (!fallback_copy) {
-            continue;
-        }
-        snprintf(fallback_copy, len, "%s", fallback_news[i]);
+    }
+    // Stories still arrive after the last poll; the push thread runs until shutdown
+    if (worker->push_thread) {
+        while (!SDL_AtomicGet(&worker->shutdown)) wait_for_refresh(worker, 0);
+    }
+    stop_push_source(worker);
+    release_fetch_handles(worker);
+    return 0;
+}
+
+// Lazily builds a source's long-lived easy handle; options that never change are set once here
+static CURL *feed_source_handle(struct FetchWorker *worker, struct FeedSource *source) {
+    if (source->curl) return source->curl;
 
-        int color_index = 0;
-        if (config->num_colors > 0) {
-            color_index = rand() % config->num_colors;
+    CURL *curl_handle = curl_easy_init();
+    if (!curl_handle) return NULL;
+
+    // Only the worker thread touches the share, so no lock callbacks are needed
+    if (!worker->share) {
+        worker->share = curl_share_init();
+        if (worker->share) {
+            curl_share_setopt(worker->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(worker->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if LIBCURL_VERSION_NUM >= 0x073900
+            curl_share_setopt(worker->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
         }
-        SDL_Color color = config->colors[color_index];
-        if (init_news_line(&news_lines[num_headlines], renderer, font, fallback_copy, true, color, screen_width, screen_height, &y_cursor, config)) {
-            num_headlines++;
+    }
+    if (worker->share) {
+        curl_easy_setopt(curl_handle, CURLOPT_SHARE, worker->share);
+    }
+
+    curl_easy_setopt(curl_handle, CURLOPT_URL, source->url);
+    curl_easy_setopt(curl_handle, CURLOPT_PRIVATE, (void *)source);
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, FeedWriteCallback);
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, (void *)&source->receiver);
+    curl_easy_setopt(curl_handle, CURLOPT_HEADERFUNCTION, HeaderCallback);
+    curl_easy_setopt(curl_handle, CURLOPT_HEADERDATA, (void *)&source->receiver);
+    curl_easy_setopt(curl_handle, CURLOPT_USERAGENT, "news-ticker/1.0");
+    // Per source, so one slow feed can't hold the whole pass hostage
+    curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT_MS, (long)worker->config.source_timeout_ms);
+    // RSS hosts commonly redirect http to https or to a CDN
+    curl_easy_setopt(curl_handle, CURLOPT_FOLLOWLOCATION, 1L);
+    // Signals are process-wide and unsafe off the main thread
+    curl_easy_setopt(curl_handle, CURLOPT_NOSIGNAL, 1L);
+    // Keep idle connections alive between refreshes so the next one skips the TCP and TLS handshakes
+    curl_easy_setopt(curl_handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl_handle, CURLOPT_TCP_KEEPIDLE, 30L);
+    curl_easy_setopt(curl_handle, CURLOPT_TCP_KEEPINTVL, 15L);
+    // Lets shutdown interrupt a transfer instead of waiting out the timeout
+    curl_easy_setopt(curl_handle, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(curl_handle, CURLOPT_XFERINFOFUNCTION, fetch_abort_callback);
+    curl_easy_setopt(curl_handle, CURLOPT_XFERINFODATA, (void *)worker);
+    curl_easy_setopt(curl_handle, CURLOPT_ERRORBUFFER, source->curl_error);
+
+    source->curl = curl_handle;
+    return curl_handle;
+}
+
+static void release_fetch_handles(struct FetchWorker *worker) {
+    for (int i = 0; i < worker->source_count; ++i) {
+        struct FeedSource *source = &worker->sources[i];
+        if (source->curl) {
+            if (source->active && worker->multi) {
+                curl_multi_remove_handle(worker->multi, source->curl);
+            }
+            curl_easy_cleanup(source->curl);
+            source->curl = NULL;
         }
+        curl_slist_free_all(source->request_headers);
+        source->request_headers = NULL;
+        json_scanner_free(&source->receiver.scanner);
+        free_memory(&source->response);
+        release_batch_storage(&source->latest);
+        release_batch_storage(&source->incoming);
+    }
+    if (worker->multi) {
+        curl_multi_cleanup(worker->multi);
+        worker->multi = NULL;
+    }
+    if (worker->share) {
+        curl_share_cleanup(worker->share);
+        worker->share = NULL;
+    }
+}
+
+// Waits up to ms; returns false as soon as shutdown is requested
+static bool fetch_worker_sleep(struct FetchWorker *worker, Uint32 ms) {
+    Uint32 deadline = SDL_GetTicks() + ms;
+    SDL_LockMutex(worker->lock);
+    while (!SDL_AtomicGet(&worker->shutdown)) {
+        Uint32 now = SDL_GetTicks();
+        if (SDL_TICKS_PASSED(now, deadline)) break;
+        SDL_CondWaitTimeout(worker->wake, worker->lock, deadline - now);
     }
+    SDL_UnlockMutex(worker->lock);
+    return !SDL_AtomicGet(&worker->shutdown);
+}
 
-    if (status_out && status_len > 0) {
-        if (fetch_error[0]) {
-            snprintf(status_out, status_len, "Fallback headlines (%s).", fetch_error);
-        } else if (config_error_message && config_error_message[0] != '\0') {
-            snprintf(status_out, status_len, "Fallback headlines (configuration issue).");
-        } else {
-            snprintf(status_out, status_len, "Fallback headlines loaded.");
+// Waits out the refresh interval, or until asked when ms is 0; false once shutdown is requested
+static bool wait_for_refresh(struct FetchWorker *worker, Uint32 ms) {
+    Uint32 deadline = SDL_GetTicks() + ms;
+    SDL_LockMutex(worker->lock);
+    while (!SDL_AtomicGet(&worker->shutdown) && !SDL_AtomicGet(&worker->refresh_requested)) {
+        if (ms == 0) {
+            SDL_CondWait(worker->wake, worker->lock);
+            continue;
         }
+        Uint32 now = SDL_GetTicks();
+        if (SDL_TICKS_PASSED(now, deadline)) break;
+        SDL_CondWaitTimeout(worker->wake, worker->lock, deadline - now);
     }
+    SDL_UnlockMutex(worker->lock);
+    SDL_AtomicSet(&worker->refresh_requested, 0);
+    return !SDL_AtomicGet(&worker->shutdown);
+}
 
-    return num_headlines;
+static int fetch_abort_callback(void *clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow) {
+    (void)dltotal;
+    (void)dlnow;
+    (void)ultotal;
+    (void)ulnow;
+    struct FetchWorker *worker = (struct FetchWorker *)clientp;
+    return SDL_AtomicGet(&worker->shutdown) ? 1 : 0;
 }
 
-static int fetch_newsapi_headlines(const struct Config *config, SDL_Renderer *renderer, TTF_Font *font, struct NewsLine *news_lines, int screen_width, int screen_height, int *y_cursor, char *fetch_error, size_t fetch_error_len) {
-    if (fetch_error && fetch_error_len > 0) {
-        fetch_error[0] = '\0';
+bool start_control_worker(struct ControlWorker *worker, const struct Config *config, struct FetchWorker *fetch) {
+    memset(worker, 0, sizeof(*worker));
+    worker->fetch = fetch;
+    if (config->control_port == 0) return false;
+
+    if (!control_listen(&worker->server, config->control_port)) {
+        fprintf(stderr, "Control endpoint unavailable: can't listen on 127.0.0.1:%d.\n", config->control_port);
+        return false;
     }
+    worker->wake_event = SDL_RegisterEvents(1);
+    worker->thread = SDL_CreateThread(control_worker_main, "news-control", worker);
+    if (!worker->thread) {
+        fprintf(stderr, "Unable to start control thread: %s\n", SDL_GetError());
+        control_close(&worker->server);
+        return false;
+    }
+    fprintf(stdout, "Control endpoint on http://127.0.0.1:%d/ (GET /metrics; POST /pause, /resume, /refresh, /headline).\n", config->control_port);
+    return true;
+}
 
-    if (!config || !renderer || !font || !news_lines || !y_cursor) {
-        if (fetch_error && fetch_error_len > 0) {
-            snprintf(fetch_error, fetch_error_len, "Invalid arguments supplied to fetch_newsapi_headlines.");
+void stop_control_worker(struct ControlWorker *worker) {
+    SDL_AtomicSet(&worker->shutdown, 1);
+    if (worker->thread) {
+        SDL_WaitThread(worker->thread, NULL);
+        worker->thread = NULL;
+    }
+    control_close(&worker->server);
+}
+
+static int control_worker_main(void *data) {
+    struct ControlWorker *worker = (struct ControlWorker *)data;
+    struct ControlRequest request;
+    while (!SDL_AtomicGet(&worker->shutdown)) {
+        int status = control_accept(&worker->server, CONTROL_ACCEPT_TIMEOUT_MS, &request);
+        if (status < 0) {
+            fprintf(stderr, "Control endpoint stopped listening.\n");
+            break;
         }
-        return 0;
+        if (status > 0) handle_control_request(worker, &request);
     }
+    return 0;
+}
 
-    char api_url[512];
-    snprintf(api_url, sizeof(api_url), "https://newsapi.org/v2/top-headlines?country=%s&pageSize=%d&apiKey=%s", config->country_code, MAX_LINES, config->api_key);
-    fprintf(stdout, "Attempting to fetch news from: %s\n", api_url);
+static void handle_control_request(struct ControlWorker *worker, struct ControlRequest *request) {
+    char *query = strchr(request->path, '?');
+    if (query) *query = '\0';
+    const bool post = strcmp(request->method, "POST") == 0;
 
-    CURL* curl_handle = curl_easy_init();
-    if (!curl_handle) {
-        if (fetch_error && fetch_error_len > 0) {
-            snprintf(fetch_error, fetch_error_len, "Unable to initialize network client.");
+    if (strcmp(request->path, "/metrics") == 0) {
+        if (strcmp(request->method, "GET") != 0) {
+            control_respond(request, 405, "text/plain", "Use GET\n", 8);
+            return;
         }
-        return 0;
+        char *text = malloc(CONTROL_METRICS_MAX);
+        if (!text) {
+            control_respond(request, 503, "text/plain", "Out of memory\n", 14);
+            return;
+        }
+        struct ControlMetrics metrics;
+        read_control_metrics(&worker->board, &metrics);
+        size_t length = format_control_metrics(&metrics, text, CONTROL_METRICS_MAX);
+        control_respond(request, 200, "text/plain; version=0.0.4", text, length);
+        free(text);
+        return;
     }
 
-    curl_easy_setopt(curl_handle, CURLOPT_URL, api_url);
-    curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, WriteMemoryCallback);
-    curl_easy_setopt(curl_handle, CURLOPT_USERAGENT, "news-ticker/1.0");
-    curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT_MS, 5000L);
-    char curl_error[CURL_ERROR_SIZE] = {0};
-    curl_easy_setopt(curl_handle, CURLOPT_ERRORBUFFER, curl_error);
+    struct ControlCommand command = {0};
+    if (strcmp(request->path, "/pause") == 0) {
+        command.kind = CONTROL_PAUSE;
+    } else if (strcmp(request->path, "/resume") == 0) {
+        command.kind = CONTROL_RESUME;
+    } else if (strcmp(request->path, "/headline") == 0) {
+        command.kind = CONTROL_INJECT;
+        memcpy(command.text, request->body, request->body_len + 1);
+    } else if (strcmp(request->path, "/refresh") != 0) {
+        control_respond(request, 404, "text/plain", "Not found\n", 10);
+        return;
+    }
+    if (!post) {
+        control_respond(request, 405, "text/plain", "Use POST\n", 9);
+        return;
+    }
+    // Any page open in a browser on this machine can reach loopback; only local tools may drive the ticker
+    if (request->from_browser) {
+        control_respond(request, 403, "text/plain", "Cross-origin requests are refused\n", 34);
+        return;
+    }
 
-    int num_headlines = 0;
-    for (int attempt = 0; attempt < MAX_FETCH_ATTEMPTS && num_headlines == 0; ++attempt) {
-        struct MemoryStruct chunk = { .memory = malloc(1), .size = 0 };
-        if (!chunk.memory) {
-            if (fetch_error && fetch_error_len > 0) {
-                snprintf(fetch_error, fetch_error_len, "Out of memory before requesting headlines.");
-            }
-            break;
+    if (strcmp(request->path, "/refresh") == 0) {
+        request_refresh(worker->fetch);
+        control_respond(request, 202, "text/plain", "Refresh requested\n", 18);
+        return;
+    }
+    if (command.kind == CONTROL_INJECT && request->body_len == 0) {
+        control_respond(request, 400, "text/plain", "Send the headline as the request body\n", 38);
+        return;
+    }
+    if (!push_control_command(&worker->commands, &command)) {
+        control_respond(request, 503, "text/plain", "Command queue full\n", 19);
+        return;
+    }
+    if (worker->wake_event != (Uint32)-1) {
+        SDL_Event wake;
+        SDL_zero(wake);
+        wake.type = worker->wake_event;
+        SDL_PushEvent(&wake);
+    }
+    control_respond(request, 202, "text/plain", "Queued\n", 7);
+}
+
+static bool push_control_command(struct CommandQueue *queue, const struct ControlCommand *command) {
+    int head = SDL_AtomicGet(&queue->head);
+    if (head - SDL_AtomicGet(&queue->tail) >= CONTROL_QUEUE_SLOTS) return false;
+    queue->slots[head % CONTROL_QUEUE_SLOTS] = *command;
+    // The slot must be complete before the render loop can see the new head
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&queue->head, head + 1);
+    return true;
+}
+
+static bool pop_control_command(struct CommandQueue *queue, struct ControlCommand *command) {
+    int tail = SDL_AtomicGet(&queue->tail);
+    if (tail == SDL_AtomicGet(&queue->head)) return false;
+    SDL_MemoryBarrierAcquire();
+    *command = queue->slots[tail % CONTROL_QUEUE_SLOTS];
+    SDL_AtomicSet(&queue->tail, tail + 1);
+    return true;
+}
+
+void publish_control_metrics(struct MetricsBoard *board, const struct ControlMetrics *metrics) {
+    SDL_AtomicIncRef(&board->sequence);
+    SDL_MemoryBarrierRelease();
+    board->metrics = *metrics;
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicIncRef(&board->sequence);
+}
+
+static void read_control_metrics(struct MetricsBoard *board, struct ControlMetrics *metrics) {
+    for (;;) {
+        int before = SDL_AtomicGet(&board->sequence);
+        if (before & 1) {
+            SDL_Delay(1); // Mid-write; a copy takes microseconds
+            continue;
         }
-        curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, (void *)&chunk);
+        SDL_MemoryBarrierAcquire();
+        *metrics = board->metrics;
+        SDL_MemoryBarrierAcquire();
+        if (SDL_AtomicGet(&board->sequence) == before) return;
+    }
+}
 
-        CURLcode res = curl_easy_perform(curl_handle);
-        if (res != CURLE_OK) {
-            if (fetch_error && fetch_error_len > 0) {
-                snprintf(fetch_error, fetch_error_len, "Request failed (%s)", curl_error[0] ? curl_error : curl_easy_strerror(res));
-            }
-        } else {
-            cJSON* json = cJSON_Parse(chunk.memory);
-            if (json == NULL) {
-                if (fetch_error && fetch_error_len > 0) {
-                    snprintf(fetch_error, fetch_error_len, "NewsAPI returned invalid JSON.");
-                }
-            } else {
-                cJSON* status = cJSON_GetObjectItemCaseSensitive(json, "status");
-                if (!cJSON_IsString(status) || strcmp(status->valuestring, "ok") != 0) {
-                    if (fetch_error && fetch_error_len > 0) {
-                        snprintf(fetch_error, fetch_error_len, "NewsAPI error: status != ok.");
-                    }
-                } else {
-                    cJSON* articles = cJSON_GetObjectItemCaseSensitive(json, "articles");
-                    cJSON* article = NULL;
-                    cJSON_ArrayForEach(article, articles) {
-                        if (!cJSON_IsObject(article)) continue;
-                        if (num_headlines >= MAX_LINES) break;
-
-                        cJSON* title_json = cJSON_GetObjectItemCaseSensitive(article, "title");
-                        if (!cJSON_IsString(title_json) || !title_json->valuestring) continue;
-
-                        char* sanitized = sanitize_headline(title_json->valuestring);
-                        if (!sanitized || sanitized[0] == '\0') {
-                            if (sanitized) free(sanitized);
-                            continue;
-                        }
-
-                        size_t final_len = strlen(sanitized) + 2;
-                        char* headline = malloc(final_len);
-                        if (!headline) {
-                            free(sanitized);
-                            if (fetch_error && fetch_error_len > 0) {
-                                snprintf(fetch_error, fetch_error_len, "Out of memory building headline.");
-                            }
-                            break;
-                        }
-                        snprintf(headline, final_len, "%s ", sanitized);
-                        free(sanitized);
-
-                        int color_index = 0;
-                        if (config->num_colors > 0) {
-                            color_index = rand() % config->num_colors;
-                        }
-                        SDL_Color color = config->colors[color_index];
-                        if (init_news_line(&news_lines[num_headlines], renderer, font, headline, true, color, screen_width, screen_height, y_cursor, config)) {
-                            num_headlines++;
-                        }
-                    }
+// Prometheus text exposition format
+static size_t format_control_metrics(const struct ControlMetrics *metrics, char *buffer, size_t size) {
+    size_t used = 0;
+    buffer[0] = '\0';
+    const struct FrameSummary *frames = &metrics->frames;
+    append_format(buffer, size, &used, "# TYPE news_ticker_uptime_seconds gauge\nnews_ticker_uptime_seconds %.1f\n", metrics->uptime_seconds);
+    append_format(buffer, size, &used, "# TYPE news_ticker_paused gauge\nnews_ticker_paused %d\n", metrics->paused ? 1 : 0);
+    append_format(buffer, size, &used, "# TYPE news_ticker_headlines gauge\nnews_ticker_headlines %d\n", metrics->headlines);
 
-                    if (num_headlines > 0 && fetch_error && fetch_error_len > 0) {
-                        fetch_error[0] = '\0';
-                    }
-                }
-                cJSON_Delete(json);
+    append_format(buffer, size, &used, "# HELP news_ticker_fps Presents per second over the last %d frames.\n", frames->frames);
+    append_format(buffer, size, &used, "# TYPE news_ticker_fps gauge\nnews_ticker_fps %.2f\n", frames->fps);
+    append_format(buffer, size, &used, "# TYPE news_ticker_frame_ms gauge\n");
+    append_format(buffer, size, &used, "news_ticker_frame_ms{stat=\"avg\"} %.3f\n", frames->frame_avg_ms);
+    append_format(buffer, size, &used, "news_ticker_frame_ms{stat=\"p99\"} %.3f\n", frames->frame_p99_ms);
+    append_format(buffer, size, &used, "news_ticker_frame_ms{stat=\"max\"} %.3f\n", frames->frame_max_ms);
+    append_format(buffer, size, &used, "# TYPE news_ticker_frame_phase_ms gauge\n");
+    append_format(buffer, size, &used, "news_ticker_frame_phase_ms{phase=\"update\"} %.3f\n", frames->update_ms);
+    append_format(buffer, size, &used, "news_ticker_frame_phase_ms{phase=\"render\"} %.3f\n", frames->render_ms);
+    append_format(buffer, size, &used, "news_ticker_frame_phase_ms{phase=\"present\"} %.3f\n", frames->present_ms);
+    append_format(buffer, size, &used, "# TYPE news_ticker_frames_late gauge\nnews_ticker_frames_late %d\n", frames->late);
+    append_format(buffer, size, &used, "# TYPE news_ticker_missed_presents_total counter\nnews_ticker_missed_presents_total %d\n", metrics->missed_presents);
+
+    append_format(buffer, size, &used, "# TYPE news_ticker_refreshes_total counter\nnews_ticker_refreshes_total %d\n", metrics->refreshes);
+    if (metrics->has_refresh) {
+        const struct RefreshMetrics *refresh = &metrics->refresh;
+        append_format(buffer, size, &used, "# TYPE news_ticker_refresh_ms gauge\nnews_ticker_refresh_ms %.3f\n", refresh->total_ms);
+        append_format(buffer, size, &used, "# HELP news_ticker_fetch_ms Phases of each feed's latest request.\n# TYPE news_ticker_fetch_ms gauge\n");
+        for (int i = 0; i < refresh->source_count; ++i) {
+            const struct SourceTiming *timing = &refresh->sources[i];
+            const char *phases[] = {"dns", "connect", "tls", "wait", "transfer", "parse"};
+            const double values[] = {timing->dns_ms, timing->connect_ms, timing->tls_ms, timing->wait_ms, timing->transfer_ms, timing->parse_ms};
+            for (int p = 0; p < 6; ++p) {
+                append_format(buffer, size, &used, "news_ticker_fetch_ms{source=\"%s\",phase=\"%s\"} %.3f\n", timing->name, phases[p], values[p]);
             }
         }
-
-        free(chunk.memory);
-        if (num_headlines > 0) {
-            break;
+        append_format(buffer, size, &used, "# TYPE news_ticker_fetch_ok gauge\n");
+        for (int i = 0; i < refresh->source_count; ++i) {
+            append_format(buffer, size, &used, "news_ticker_fetch_ok{source=\"%s\",http_code=\"%ld\"} %d\n", refresh->sources[i].name, refresh->sources[i].http_code,
+                          refresh->sources[i].ok ? 1 : 0);
         }
-        if (attempt < MAX_FETCH_ATTEMPTS - 1) {
-            SDL_Delay(250 * (attempt + 1));
+        append_format(buffer, size, &used, "# TYPE news_ticker_fetch_bytes gauge\n");
+        for (int i = 0; i < refresh->source_count; ++i) {
+            append_format(buffer, size, &used, "news_ticker_fetch_bytes{source=\"%s\"} %zu\n", refresh->sources[i].name, refresh->sources[i].bytes);
         }
     }
 
-    curl_easy_cleanup(curl_handle);
-    return num_headlines;
+    Uint64 lookups = metrics->cache_hits + metrics->cache_misses;
+    append_format(buffer, size, &used, "# TYPE news_ticker_texture_cache_hits_total counter\nnews_ticker_texture_cache_hits_total %llu\n",
+                  (unsigned long long)metrics->cache_hits);
+    append_format(buffer, size, &used, "# TYPE news_ticker_texture_cache_misses_total counter\nnews_ticker_texture_cache_misses_total %llu\n",
+                  (unsigned long long)metrics->cache_misses);
+    append_format(buffer, size, &used, "# TYPE news_ticker_texture_cache_hit_ratio gauge\nnews_ticker_texture_cache_hit_ratio %.4f\n",
+                  lookups > 0 ? (double)metrics->cache_hits / (double)lookups : 0.0);
+    append_format(buffer, size, &used, "# TYPE news_ticker_shape_cache_hits_total counter\nnews_ticker_shape_cache_hits_total %d\n", metrics->shape_hits);
+    append_format(buffer, size, &used, "# TYPE news_ticker_shape_cache_misses_total counter\nnews_ticker_shape_cache_misses_total %d\n", metrics->shape_misses);
+
+    const struct TextureBudget *textures = &metrics->textures;
+    append_format(buffer, size, &used, "# TYPE news_ticker_texture_bytes gauge\nnews_ticker_texture_bytes %zu\n", metrics->texture_bytes);
+    append_format(buffer, size, &used, "# TYPE news_ticker_texture_peak_bytes gauge\nnews_ticker_texture_peak_bytes %zu\n", textures->peak_bytes);
+    append_format(buffer, size, &used, "# HELP news_ticker_texture_limit_bytes Texture budget; 0 when uncapped.\n");
+    append_format(buffer, size, &used, "# TYPE news_ticker_texture_limit_bytes gauge\nnews_ticker_texture_limit_bytes %zu\n", textures->limit_bytes);
+    append_format(buffer, size, &used, "# TYPE news_ticker_texture_evictions_total counter\nnews_ticker_texture_evictions_total %d\n", textures->evictions);
+    append_format(buffer, size, &used, "# TYPE news_ticker_texture_deferrals_total counter\nnews_ticker_texture_deferrals_total %d\n", textures->deferrals);
+    return used;
+}
+
+// snprintf onto the end of buffer; output that doesn't fit is dropped
+static void append_format(char *buffer, size_t size, size_t *used, const char *format, ...) {
+    if (*used >= size - 1) return;
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(buffer + *used, size - *used, format, args);
+    va_end(args);
+    if (written < 0) return;
+    *used = (size_t)written < size - *used ? *used + (size_t)written : size - 1;
 }
 
 void append_message(char *buffer, size_t len, const char *message) {
@@ -736,48 +6296,3 @@ void append_message(char *buffer, size_t len, const char *message) {
     }
     strncat(buffer, message, len - current - 1);
 }
-
-char normalize_ascii_char(unsigned char c) {
-    if (c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f') {
-        return ' ';
-    }
-    if (c == '\0') {
-        return '\0';
-    }
-    if (isalnum(c)) {
-        return (char)c;
-    }
-    switch (c) {
-        case ' ':
-        case '.':
-        case ',':
-        case ':':
-        case ';':
-        case '!':
-        case '?':
-        case '\'':
-        case '"':
-        case '-':
-        case '_':
-        case '/':
-        case '&':
-        case '(': 
-        case ')':
-        case '[':
-        case ']':
-        case '#':
-        case '$':
-        case '+':
-            return (char)c;
-        default:
-            return '\0';
-    }
-}
-
-size_t utf8_sequence_length(unsigned char lead_byte) {
-    if ((lead_byte & 0x80) == 0) return 1;
-    if ((lead_byte & 0xE0) == 0xC0) return 2;
-    if ((lead_byte & 0xF0) == 0xE0) return 3;
-    if ((lead_byte & 0xF8) == 0xF0) return 4;
-    return 0;
-}
@@ -0,0 +1,274 @@
+/*
+ * sanitize.c - Reduces feed titles to the characters the ticker renders.
+ *
+ * Whitespace controls become spaces, runs of spaces collapse, ASCII punctuation outside a small
+ * whitelist is dropped, and well-formed UTF-8 passes through untouched apart from invisible
+ * format characters and Unicode spaces. Malformed bytes each become a space. Runs of plain ASCII
+ * are checked and copied sixteen bytes at a time where SSE2 is available; everything else goes
+ * through a 256-entry byte class table.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "sanitize.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SANITIZE_SSE2 1
+#define PLAIN_BLOCK 16
+#endif
+
+// What a byte means on its own; lead classes stay in this order so one comparison finds them
+enum ByteClass {
+    BYTE_DROP,
+    BYTE_KEEP,
+    BYTE_SPACE,
+    BYTE_LEAD2,
+    BYTE_LEAD3,
+    BYTE_LEAD4,
+    BYTE_INVALID // Continuation bytes, overlong leads C0/C1, and leads past U+10FFFF
+};
+
+#define D BYTE_DROP
+#define K BYTE_KEEP
+#define S BYTE_SPACE
+#define L2 BYTE_LEAD2
+#define L3 BYTE_LEAD3
+#define L4 BYTE_LEAD4
+#define X BYTE_INVALID
+static const unsigned char byte_classes[256] = {
+     D,  D,  D,  D,  D,  D,  D,  D,  D,  S,  S,  S,  S,  S,  D,  D, // 0x00
+     D,  D,  D,  D,  D,  D,  D,  D,  D,  D,  D,  D,  D,  D,  D,  D, // 0x10
+     S,  K,  K,  K,  K,  D,  K,  K,  K,  K,  D,  K,  K,  K,  K,  K, // 0x20
+     K,  K,  K,  K,  K,  K,  K,  K,  K,  K,  K,  K,  D,  D,  D,  K, // 0x30
+     D,  K,  K,  K,  K,  K,  K,  K,  K,  K,  K,  K,  K,  K,  K,  K, // 0x40
+     K,  K,  K,  K,  K,  K,  K,  K,  K,  K,  K,  K,  D,  K,  D,  K, // 0x50
+     D,  K,  K,  K,  K,  K,  K,  K,  K,  K,  K,  K,  K,  K,  K,  K, // 0x60
+     K,  K,  K,  K,  K,  K,  K,  K,  K,  K,  K,  D,  D,  D,  D,  D, // 0x70
+     X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X, // 0x80
+     X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X, // 0x90
+     X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X, // 0xA0
+     X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X, // 0xB0
+     X,  X, L2, L2, L2, L2, L2, L2, L2, L2, L2, L2, L2, L2, L2, L2, // 0xC0
+    L2, L2, L2, L2, L2, L2, L2, L2, L2, L2, L2, L2, L2, L2, L2, L2, // 0xD0
+    L3, L3, L3, L3, L3, L3, L3, L3, L3, L3, L3, L3, L3, L3, L3, L3, // 0xE0
+    L4, L4, L4, L4, L4,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X, // 0xF0
+};
+#undef D
+#undef K
+#undef S
+#undef L2
+#undef L3
+#undef L4
+#undef X
+
+// Unicode spaces render as gaps, format controls as nothing, and C1 controls were never text
+static enum ByteClass codepoint_class(uint32_t cp) {
+    if (cp < 0xA0) return BYTE_SPACE;
+    if (cp > 0xAD && cp < 0x1680) return BYTE_KEEP; // Latin through Ethiopic, the common case
+    if (cp > 0x3000 && cp < 0xFEFF) return BYTE_KEEP; // CJK, Hangul, private use
+    if (cp == 0xA0 || cp == 0x1680 || (cp >= 0x2000 && cp <= 0x200A) || cp == 0x2028 || cp == 0x2029
+        || cp == 0x202F || cp == 0x205F || cp == 0x3000 || cp == 0xFFFD) {
+        return BYTE_SPACE;
+    }
+    if (cp == 0xAD || (cp >= 0x200B && cp <= 0x200F) || (cp >= 0x202A && cp <= 0x202E)
+        || (cp >= 0x2060 && cp <= 0x206F) || cp == 0xFEFF || (cp >= 0xFFF9 && cp <= 0xFFFC)
+        || cp == 0xFFFE || cp == 0xFFFF) {
+        return BYTE_DROP;
+    }
+    return BYTE_KEEP;
+}
+
+// Marks that draw onto their neighbour; a missing one is dropped rather than turned into a gap
+static bool is_zero_width(uint32_t cp) {
+    return (cp >= 0x0300 && cp <= 0x036F) || (cp >= 0x1AB0 && cp <= 0x1AFF) || (cp >= 0x20D0 && cp <= 0x20FF)
+        || (cp >= 0xFE00 && cp <= 0xFE0F) || (cp >= 0xFE20 && cp <= 0xFE2F) || (cp >= 0xE0100 && cp <= 0xE01EF);
+}
+
+#ifdef SANITIZE_SSE2
+// True when all sixteen bytes are whitelisted ASCII with no space run the output would collapse
+static inline bool plain_ascii_block(const unsigned char *src, bool last_was_space) {
+    __m128i v = _mm_loadu_si128((const __m128i *)src);
+    // Below 0x20, or from '{' up, which also catches every non-ASCII byte
+    __m128i bad = _mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1F)), v),
+                               _mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(0x7B)), v));
+    __m128i angle = _mm_sub_epi8(v, _mm_set1_epi8('<')); // '<' '=' '>'
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(_mm_min_epu8(angle, _mm_set1_epi8(2)), angle));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(v, _mm_set1_epi8('%')));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(v, _mm_set1_epi8('*')));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(v, _mm_set1_epi8('@')));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(v, _mm_set1_epi8('^')));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(v, _mm_set1_epi8('`')));
+    if (_mm_movemask_epi8(bad) != 0) return false;
+
+    unsigned spaces = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+    if (spaces & (spaces >> 1)) return false;
+    return !((spaces & 1) && last_was_space);
+}
+#endif
+
+// Strict decoder shared by the sanitizer loop and the exported utf8_decode()
+static inline size_t decode_utf8(const unsigned char *s, uint32_t *codepoint) {
+    if (s[0] < 0x80) {
+        *codepoint = s[0];
+        return 1;
+    }
+    // Second-byte bounds exclude overlong forms, UTF-16 surrogates and anything past U+10FFFF
+    unsigned char low = 0x80;
+    unsigned char high = 0xBF;
+    size_t len;
+    uint32_t cp;
+    switch (byte_classes[s[0]]) {
+        case BYTE_LEAD2:
+            len = 2;
+            cp = s[0] & 0x1F;
+            break;
+        case BYTE_LEAD3:
+            len = 3;
+            cp = s[0] & 0x0F;
+            if (s[0] == 0xE0) low = 0xA0;
+            else if (s[0] == 0xED) high = 0x9F;
+            break;
+        case BYTE_LEAD4:
+            len = 4;
+            cp = s[0] & 0x07;
+            if (s[0] == 0xF0) low = 0x90;
+            else if (s[0] == 0xF4) high = 0x8F;
+            break;
+        default:
+            return 0;
+    }
+    if (s[1] < low || s[1] > high) return 0;
+    cp = (cp << 6) | (s[1] & 0x3F);
+    // Each continuation is checked before the next is read, so a terminator is never overrun
+    for (size_t k = 2; k < len; ++k) {
+        if ((s[k] & 0xC0) != 0x80) return 0;
+        cp = (cp << 6) | (s[k] & 0x3F);
+    }
+    *codepoint = cp;
+    return len;
+}
+
+// Sanitizes the character at s into buffer and returns how many input bytes it consumed
+static inline size_t sanitize_unit(const unsigned char *s, char *buffer, size_t *out, bool *last_was_space) {
+    enum ByteClass cls = (enum ByteClass)byte_classes[*s];
+    size_t len = 1;
+    if (cls >= BYTE_LEAD2) {
+        uint32_t cp = 0;
+        len = decode_utf8(s, &cp);
+        if (len == 0) {
+            len = 1; // A malformed byte stands in for the character it garbled
+            cls = BYTE_SPACE;
+        } else {
+            cls = codepoint_class(cp);
+        }
+    }
+
+    if (cls == BYTE_KEEP) {
+        memcpy(buffer + *out, s, len);
+        *out += len;
+        *last_was_space = false;
+    } else if (cls == BYTE_SPACE && !*last_was_space) {
+        buffer[(*out)++] = ' ';
+        *last_was_space = true;
+    }
+    return len;
+}
+
+char* sanitize_headline(const char *title) {
+    if (!title) return NULL;
+    size_t len = strlen(title);
+    if (len == 0) return NULL;
+
+    char *buffer = malloc(len + 1);
+    if (!buffer) return NULL;
+
+    sanitize_headline_to(title, buffer);
+    return buffer;
+}
+
+size_t sanitize_headline_to(const char *title, char *buffer) {
+    const unsigned char *in = (const unsigned char *)title;
+    size_t len = strlen(title);
+    size_t i = 0;
+    size_t out = 0;
+    bool last_was_space = true; // Never start with a space
+    while (i < len) {
+        size_t block_end = len;
+#ifdef SANITIZE_SSE2
+        if (i + PLAIN_BLOCK <= len) {
+            if (plain_ascii_block(in + i, last_was_space)) {
+                // out never passes i, so the store stays inside the strlen(title) + 1 bytes owed
+                _mm_storeu_si128((__m128i *)(buffer + out), _mm_loadu_si128((const __m128i *)(in + i)));
+                last_was_space = in[i + PLAIN_BLOCK - 1] == ' ';
+                i += PLAIN_BLOCK;
+                out += PLAIN_BLOCK;
+                continue;
+            }
+            // Finish the rejected block in scalar so non-Latin text isn't re-tested at every byte
+            block_end = i + PLAIN_BLOCK;
+        }
+#endif
+        while (i < block_end) {
+            i += sanitize_unit(in + i, buffer, &out, &last_was_space);
+        }
+    }
+
+    while (out > 0 && buffer[out - 1] == ' ') {
+        --out;
+    }
+
+    buffer[out] = '\0';
+
+    return out;
+}
+
+size_t sanitize_filter_glyphs(char *text, bool (*provided)(uint32_t codepoint, void *ctx), void *ctx) {
+    size_t in = 0;
+    size_t out = 0;
+    while (text[in]) {
+        unsigned char c = (unsigned char)text[in];
+        uint32_t cp = 0xFFFD;
+        size_t len = c < 0x80 ? 1 : decode_utf8((const unsigned char *)text + in, &cp);
+        if (len == 0) len = 1;
+
+        bool keep = c < 0x80 || (len > 1 && provided(cp, ctx));
+        if (keep && c != ' ') {
+            memmove(text + out, text + in, len);
+            out += len;
+        } else if ((keep || !is_zero_width(cp)) && out > 0 && text[out - 1] != ' ') {
+            // Existing spaces and the gaps left by dropped glyphs collapse into one
+            text[out++] = ' ';
+        }
+        in += len;
+    }
+    text[out] = '\0';
+    return out;
+}
+
+char normalize_ascii_char(unsigned char c) {
+    switch (byte_classes[c]) {
+        case BYTE_KEEP:
+            return (char)c;
+        case BYTE_SPACE:
+            return ' ';
+        default:
+            return '\0';
+    }
+}
+
+size_t utf8_sequence_length(unsigned char lead_byte) {
+    switch (byte_classes[lead_byte]) {
+        case BYTE_LEAD2: return 2;
+        case BYTE_LEAD3: return 3;
+        case BYTE_LEAD4: return 4;
+        case BYTE_INVALID: return 0;
+        default: return 1;
+    }
+}
+
+size_t utf8_decode(const char *text, uint32_t *codepoint) {
+    return decode_utf8((const unsigned char *)text, codepoint);
+}
@@ -0,0 +1,26 @@
+/*
+ * sanitize.h - Headline text cleaning shared by the ticker and bench/bench_sanitize.c.
+ *
+ * Kept free of SDL and curl so the sanitizer can be benchmarked and checked on its own.
+ */
+
+#ifndef SANITIZE_H
+#define SANITIZE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Returns a malloc'd cleaned copy of title, or NULL for empty input or allocation failure
+char* sanitize_headline(const char *title);
+// Writes the cleaned title into buffer, which needs strlen(title) + 1 bytes, and returns its length
+size_t sanitize_headline_to(const char *title, char *buffer);
+// Drops, in place, non-ASCII characters provided() rejects, leaving at most one space where they stood
+size_t sanitize_filter_glyphs(char *text, bool (*provided)(uint32_t codepoint, void *ctx), void *ctx);
+char normalize_ascii_char(unsigned char c);
+// Length of the UTF-8 sequence lead_byte starts, or 0 if it can't start one
+size_t utf8_sequence_length(unsigned char lead_byte);
+// Decodes one well-formed UTF-8 character from NUL-terminated text; returns its length, or 0 if malformed
+size_t utf8_decode(const char *text, uint32_t *codepoint);
+
+#endif
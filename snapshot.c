@@ -0,0 +1,208 @@
+/*
+ * snapshot.c - Reads and writes the prerasterized line snapshot.
+ *
+ * Layout: a fixed header, a table of fixed-size records, then each line's text and coverage
+ * bytes. Records hold offsets from the start of the file, so a mapped snapshot is used in place
+ * and nothing but the lines actually drawn is ever paged in.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "snapshot.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define SNAPSHOT_MAGIC "NTSNAP\0\0"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_MAX_SIDE 16384 // Far past any real line; bounds the size arithmetic below
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t count;
+    uint64_t font_id;
+};
+
+struct SnapshotRecord {
+    uint64_t key;
+    uint64_t text_offset;
+    uint64_t pixel_offset;
+    uint32_t width;
+    uint32_t height;
+    uint32_t text_len;
+    uint32_t reserved;
+};
+
+static bool read_record(const struct SnapshotFile *file, uint32_t index, struct SnapshotRecord *record) {
+    if (index >= file->count) return false;
+    memcpy(record, file->base + sizeof(struct SnapshotHeader) + (size_t)index * sizeof(*record), sizeof(*record));
+    return true;
+}
+
+// Rejects any record that would reach past the end of the file
+static bool record_fits(const struct SnapshotFile *file, const struct SnapshotRecord *record) {
+    if (record->width == 0 || record->height == 0) return false;
+    if (record->width > SNAPSHOT_MAX_SIDE || record->height > SNAPSHOT_MAX_SIDE) return false;
+    uint64_t pixels = (uint64_t)record->width * record->height;
+    return record->text_offset <= file->size && record->text_len <= file->size - record->text_offset &&
+           record->pixel_offset <= file->size && pixels <= file->size - record->pixel_offset;
+}
+
+bool snapshot_map(struct SnapshotFile *file, const char *path, uint64_t font_id) {
+    memset(file, 0, sizeof(*file));
+    if (!path || !path[0]) return false;
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart < (LONGLONG)sizeof(struct SnapshotHeader)) {
+        CloseHandle(handle);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    const void *base = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!base) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(handle);
+        return false;
+    }
+    file->file = handle;
+    file->mapping = mapping;
+    file->base = (const uint8_t *)base;
+    file->size = (size_t)size.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(struct SnapshotHeader)) {
+        close(fd);
+        return false;
+    }
+    void *base = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping keeps the file alive
+    if (base == MAP_FAILED) return false;
+    file->base = (const uint8_t *)base;
+    file->size = (size_t)info.st_size;
+#endif
+
+    struct SnapshotHeader header;
+    memcpy(&header, file->base, sizeof(header));
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 || header.version != SNAPSHOT_VERSION ||
+        header.font_id != font_id || header.count > (file->size - sizeof(header)) / sizeof(struct SnapshotRecord)) {
+        snapshot_unmap(file);
+        return false;
+    }
+    file->count = header.count;
+    for (uint32_t i = 0; i < file->count; ++i) {
+        struct SnapshotRecord record;
+        read_record(file, i, &record);
+        if (!record_fits(file, &record)) {
+            snapshot_unmap(file);
+            return false;
+        }
+    }
+    return true;
+}
+
+void snapshot_unmap(struct SnapshotFile *file) {
+    if (!file->base) return;
+#ifdef _WIN32
+    UnmapViewOfFile(file->base);
+    CloseHandle(file->mapping);
+    CloseHandle(file->file);
+#else
+    munmap((void *)file->base, file->size);
+#endif
+    memset(file, 0, sizeof(*file));
+}
+
+bool snapshot_line_at(const struct SnapshotFile *file, uint32_t index, struct SnapshotLine *out) {
+    struct SnapshotRecord record;
+    if (!file->base || !read_record(file, index, &record)) return false;
+    out->key = record.key;
+    out->text = (const char *)file->base + record.text_offset;
+    out->text_len = record.text_len;
+    out->width = record.width;
+    out->height = record.height;
+    out->coverage = file->base + record.pixel_offset;
+    return true;
+}
+
+bool snapshot_lookup(const struct SnapshotFile *file, uint64_t key, const char *text, struct SnapshotLine *out) {
+    size_t text_len = strlen(text);
+    // A few dozen records at most; a scan beats keeping an index in the file
+    for (uint32_t i = 0; i < file->count; ++i) {
+        struct SnapshotLine line;
+        snapshot_line_at(file, i, &line);
+        if (line.key == key && line.text_len == text_len && memcmp(line.text, text, text_len) == 0) {
+            *out = line;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool snapshot_save(const char *path, uint64_t font_id, const struct SnapshotLine *lines, int count) {
+    if (!path || !path[0] || count < 0) return false;
+
+    char temp_path[512];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+    FILE *out = fopen(temp_path, "wb");
+    if (!out) return false;
+
+    struct SnapshotHeader header;
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.count = (uint32_t)count;
+    header.font_id = font_id;
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1;
+
+    // Texts follow the table, then coverage; offsets are known before anything variable is written
+    uint64_t offset = sizeof(header) + (uint64_t)count * sizeof(struct SnapshotRecord);
+    uint64_t pixel_offset = offset;
+    for (int i = 0; i < count; ++i) {
+        pixel_offset += lines[i].text_len;
+    }
+    for (int i = 0; ok && i < count; ++i) {
+        struct SnapshotRecord record = {0};
+        record.key = lines[i].key;
+        record.text_offset = offset;
+        record.text_len = lines[i].text_len;
+        record.pixel_offset = pixel_offset;
+        record.width = lines[i].width;
+        record.height = lines[i].height;
+        offset += lines[i].text_len;
+        pixel_offset += (uint64_t)lines[i].width * lines[i].height;
+        ok = fwrite(&record, sizeof(record), 1, out) == 1;
+    }
+    for (int i = 0; ok && i < count; ++i) {
+        ok = fwrite(lines[i].text, 1, lines[i].text_len, out) == lines[i].text_len;
+    }
+    for (int i = 0; ok && i < count; ++i) {
+        size_t bytes = (size_t)lines[i].width * lines[i].height;
+        ok = fwrite(lines[i].coverage, 1, bytes, out) == bytes;
+    }
+    ok = fclose(out) == 0 && ok;
+    if (!ok) {
+        remove(temp_path);
+        return false;
+    }
+
+    // Write-then-rename so a crash mid-write leaves the previous snapshot intact
+#ifdef _WIN32
+    remove(path);
+#endif
+    if (rename(temp_path, path) != 0) {
+        remove(temp_path);
+        return false;
+    }
+    return true;
+}
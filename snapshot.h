@@ -0,0 +1,46 @@
+/*
+ * snapshot.h - Memory-mapped file of prerasterized headline lines for warm restarts.
+ *
+ * Each line is stored as an 8-bit coverage mask plus the key and text it was rendered from; the
+ * ticker's blended text is one flat color, so coverage is all a texture needs. The file is a
+ * local cache in native byte order and carries an identifier for the font it was rendered with.
+ * Kept free of SDL so the format can be read and written on its own.
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// One line, either borrowed from a mapped file or supplied by the caller for saving
+struct SnapshotLine {
+    uint64_t key;
+    const char *text;
+    uint32_t text_len;
+    uint32_t width;
+    uint32_t height;
+    const uint8_t *coverage; // width * height bytes, rows packed
+};
+
+struct SnapshotFile {
+    const uint8_t *base;
+    size_t size;
+    uint32_t count;
+#ifdef _WIN32
+    void *file;
+    void *mapping;
+#endif
+};
+
+// Maps path read-only; false if it is missing, corrupt, or was rendered with another font
+bool snapshot_map(struct SnapshotFile *file, const char *path, uint64_t font_id);
+void snapshot_unmap(struct SnapshotFile *file);
+// Finds the line rendered from text under key; the result points into the mapping
+bool snapshot_lookup(const struct SnapshotFile *file, uint64_t key, const char *text, struct SnapshotLine *out);
+bool snapshot_line_at(const struct SnapshotFile *file, uint32_t index, struct SnapshotLine *out);
+// Writes lines to a temporary file and renames it over path; never call while path is mapped
+bool snapshot_save(const char *path, uint64_t font_id, const struct SnapshotLine *lines, int count);
+
+#endif